@@ -2581,6 +2581,96 @@ static void test_rw_order(void)
     ok(!RegDeleteKeyA(HKEY_CURRENT_USER, keyname), "Failed to delete key\n");
 }
 
+static void test_many_entries(void)
+{
+    static const unsigned int count = 300;
+    char name[16], buffer[16];
+    unsigned int i, j;
+    HKEY hkey, subkey;
+    DWORD size, dw, type, subkeys, values;
+    LSTATUS ret;
+
+    ret = RegCreateKeyA(hkey_main, "test_many_entries", &hkey);
+    ok(!ret, "RegCreateKeyA failed, error %ld\n", ret);
+
+    /* create them out of order */
+    for (i = 0; i < count; i++)
+    {
+        j = (i * 7) % count;
+        sprintf(name, "key%03u", j);
+        ret = RegCreateKeyA(hkey, name, &subkey);
+        ok(!ret, "RegCreateKeyA %s failed, error %ld\n", name, ret);
+        RegCloseKey(subkey);
+        sprintf(name, "value%03u", j);
+        ret = RegSetValueExA(hkey, name, 0, REG_DWORD, (BYTE *)&j, sizeof(j));
+        ok(!ret, "RegSetValueExA %s failed, error %ld\n", name, ret);
+    }
+
+    ret = RegQueryInfoKeyA(hkey, NULL, NULL, NULL, &subkeys, NULL, NULL, &values, NULL, NULL, NULL, NULL);
+    ok(!ret, "RegQueryInfoKeyA failed, error %ld\n", ret);
+    ok(subkeys == count, "got %lu subkeys\n", subkeys);
+    ok(values == count, "got %lu values\n", values);
+
+    for (i = 0; i < count; i++)
+    {
+        sprintf(name, "KEY%03u", i);
+        ret = RegOpenKeyA(hkey, name, &subkey);
+        ok(!ret, "RegOpenKeyA %s failed, error %ld\n", name, ret);
+        RegCloseKey(subkey);
+        sprintf(name, "Value%03u", i);
+        size = sizeof(dw);
+        ret = RegQueryValueExA(hkey, name, NULL, &type, (BYTE *)&dw, &size);
+        ok(!ret, "RegQueryValueExA %s failed, error %ld\n", name, ret);
+        ok(dw == i, "got %lu for %s\n", dw, name);
+    }
+
+    /* subkeys are enumerated in order */
+    for (i = 0; i < count; i++)
+    {
+        size = sizeof(buffer);
+        ret = RegEnumKeyExA(hkey, i, buffer, &size, NULL, NULL, NULL, NULL);
+        ok(!ret, "RegEnumKeyExA %u failed, error %ld\n", i, ret);
+        sprintf(name, "key%03u", i);
+        ok(!strcmp(buffer, name), "got %s, expected %s\n", buffer, name);
+    }
+
+    /* delete every other entry and check the remaining ones */
+    for (i = 0; i < count; i += 2)
+    {
+        sprintf(name, "key%03u", i);
+        ret = RegDeleteKeyA(hkey, name);
+        ok(!ret, "RegDeleteKeyA %s failed, error %ld\n", name, ret);
+        sprintf(name, "value%03u", i);
+        ret = RegDeleteValueA(hkey, name);
+        ok(!ret, "RegDeleteValueA %s failed, error %ld\n", name, ret);
+    }
+    for (i = 0; i < count; i++)
+    {
+        sprintf(name, "key%03u", i);
+        ret = RegOpenKeyA(hkey, name, &subkey);
+        ok(ret == (i % 2 ? ERROR_SUCCESS : ERROR_FILE_NOT_FOUND), "RegOpenKeyA %s returned %ld\n", name, ret);
+        if (!ret) RegCloseKey(subkey);
+        sprintf(name, "value%03u", i);
+        size = sizeof(dw);
+        ret = RegQueryValueExA(hkey, name, NULL, &type, (BYTE *)&dw, &size);
+        ok(ret == (i % 2 ? ERROR_SUCCESS : ERROR_FILE_NOT_FOUND), "RegQueryValueExA %s returned %ld\n", name, ret);
+    }
+    for (i = 0; i < count / 2; i++)
+    {
+        size = sizeof(buffer);
+        ret = RegEnumKeyExA(hkey, i, buffer, &size, NULL, NULL, NULL, NULL);
+        ok(!ret, "RegEnumKeyExA %u failed, error %ld\n", i, ret);
+        sprintf(name, "key%03u", 2 * i + 1);
+        ok(!strcmp(buffer, name), "got %s, expected %s\n", buffer, name);
+    }
+    size = sizeof(buffer);
+    ret = RegEnumKeyExA(hkey, count / 2, buffer, &size, NULL, NULL, NULL, NULL);
+    ok(ret == ERROR_NO_MORE_ITEMS, "RegEnumKeyExA returned %ld\n", ret);
+
+    delete_key(hkey);
+    RegCloseKey(hkey);
+}
+
 static void test_symlinks(void)
 {
     static const WCHAR targetW[] = L"\\Software\\Wine\\Test\\target";
@@ -5185,6 +5275,7 @@ START_TEST(registry)
     test_reg_copy_tree();
     test_reg_delete_tree();
     test_rw_order();
+    test_many_entries();
     test_deleted_key();
     test_delete_value();
     test_delete_key_value();
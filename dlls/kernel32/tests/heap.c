@@ -3579,6 +3579,108 @@ static void test_child_heap( const char *arg )
     test_heap_tail_zeroing( heap_flags );
 }
 
+static WINE_HEAP_STATISTICS_INFORMATION *get_heap_statistics( HANDLE heap )
+{
+    WINE_HEAP_STATISTICS_INFORMATION *info;
+    SIZE_T size = 0;
+    BOOL ret;
+
+    ret = pHeapQueryInformation( heap, HeapWineStatisticsInformation, NULL, 0, &size );
+    ok( !ret, "HeapQueryInformation succeeded\n" );
+    ok( GetLastError() == ERROR_INSUFFICIENT_BUFFER, "got error %lu\n", GetLastError() );
+    ok( size >= offsetof( WINE_HEAP_STATISTICS_INFORMATION, Bins ), "got size %Iu\n", size );
+
+    info = HeapAlloc( GetProcessHeap(), 0, size );
+    ret = pHeapQueryInformation( heap, HeapWineStatisticsInformation, info, size, &size );
+    ok( ret, "HeapQueryInformation failed, error %lu\n", GetLastError() );
+    ok( info->Size == size, "got Size %lu, expected %Iu\n", info->Size, size );
+    return info;
+}
+
+static void test_heap_statistics_child(void)
+{
+    WINE_HEAP_STATISTICS_INFORMATION *info;
+    ULONG i, lfh_alloc = 0, lfh_free = 0;
+    void *ptrs[256];
+    HANDLE heap;
+    BOOL ret;
+
+    heap = HeapCreate( 0, 0, 0 );
+    ok( !!heap, "HeapCreate failed, error %lu\n", GetLastError() );
+
+    for (i = 0; i < ARRAY_SIZE(ptrs); i++) ptrs[i] = HeapAlloc( heap, 0, 0x10 );
+    for (i = 0; i < ARRAY_SIZE(ptrs); i++) HeapFree( heap, 0, ptrs[i] );
+
+    info = get_heap_statistics( heap );
+    ok( info->Enabled, "statistics not enabled\n" );
+    ok( info->BinCount > 0, "got BinCount %lu\n", info->BinCount );
+    for (i = 0; i < info->BinCount; i++)
+    {
+        lfh_alloc += info->Bins[i].LfhAllocCount;
+        lfh_free += info->Bins[i].LfhFreeCount;
+    }
+    ok( lfh_alloc > 0, "got LFH alloc count %lu\n", lfh_alloc );
+    ok( lfh_free > 0, "got LFH free count %lu\n", lfh_free );
+    HeapFree( GetProcessHeap(), 0, info );
+
+    ret = HeapDestroy( heap );
+    ok( ret, "HeapDestroy failed, error %lu\n", GetLastError() );
+}
+
+static void test_heap_statistics( const char *argv0 )
+{
+    WINE_HEAP_STATISTICS_INFORMATION *info;
+    ULONG commit_count;
+    PROCESS_INFORMATION pi;
+    STARTUPINFOA si = {0};
+    char cmdline[MAX_PATH];
+    void *ptrs[16];
+    HANDLE heap;
+    BOOL ret;
+    UINT i;
+
+    if (!winetest_platform_is_wine)
+    {
+        skip( "HeapWineStatisticsInformation is Wine specific\n" );
+        return;
+    }
+
+    heap = HeapCreate( 0, 0, 0 );
+    ok( !!heap, "HeapCreate failed, error %lu\n", GetLastError() );
+
+    info = get_heap_statistics( heap );
+    ok( info->SubheapCount == 1, "got SubheapCount %lu\n", info->SubheapCount );
+    ok( info->CommittedSize > 0, "got CommittedSize %Iu\n", info->CommittedSize );
+    ok( !info->LargeCount, "got LargeCount %lu\n", info->LargeCount );
+    commit_count = info->CommitCount;
+    HeapFree( GetProcessHeap(), 0, info );
+
+    for (i = 0; i < ARRAY_SIZE(ptrs); i++) ptrs[i] = HeapAlloc( heap, 0, 0x8000 );
+    ptrs[0] = HeapReAlloc( heap, 0, ptrs[0], 0x200000 );
+
+    info = get_heap_statistics( heap );
+    ok( info->CommitCount > commit_count, "got CommitCount %lu, was %lu\n", info->CommitCount, commit_count );
+    ok( info->UsedSize >= 15 * 0x8000, "got UsedSize %Iu\n", info->UsedSize );
+    ok( info->LargeCount == 1, "got LargeCount %lu\n", info->LargeCount );
+    ok( info->LargeSize >= 0x200000, "got LargeSize %Iu\n", info->LargeSize );
+    HeapFree( GetProcessHeap(), 0, info );
+
+    for (i = 0; i < ARRAY_SIZE(ptrs); i++) HeapFree( heap, 0, ptrs[i] );
+    ret = HeapDestroy( heap );
+    ok( ret, "HeapDestroy failed, error %lu\n", GetLastError() );
+
+    /* the optional counters are only maintained when WINEHEAPSTATS is set at startup */
+    SetEnvironmentVariableA( "WINEHEAPSTATS", "0" );
+    si.cb = sizeof(si);
+    sprintf( cmdline, "%s heap.c stats", argv0 );
+    ret = CreateProcessA( NULL, cmdline, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi );
+    ok( ret, "failed to create child process error %lu\n", GetLastError() );
+    wait_child_process( &pi );
+    CloseHandle( pi.hThread );
+    CloseHandle( pi.hProcess );
+    SetEnvironmentVariableA( "WINEHEAPSTATS", NULL );
+}
+
 static void test_GetPhysicallyInstalledSystemMemory(void)
 {
     MEMORYSTATUSEX memstatus;
@@ -3870,6 +3972,11 @@ START_TEST(heap)
     load_functions();
 
     argc = winetest_get_mainargs( &argv );
+    if (argc >= 3 && !strcmp( argv[2], "stats" ))
+    {
+        test_heap_statistics_child();
+        return;
+    }
     if (argc >= 3)
     {
         test_child_heap( argv[2] );
@@ -3884,6 +3991,7 @@ START_TEST(heap)
     test_GlobalMemoryStatus();
     test_HeapSummary();
     test_heap_tail_zeroing( 0 );
+    test_heap_statistics( argv[0] );
 
     if (pRtlGetNtGlobalFlags)
     {
@@ -2122,6 +2122,22 @@ static void test_CompareStringW(void)
     ok(ret == CSTR_LESS_THAN, "expected CSTR_LESS_THAN, got %d\n", ret);
     ret = CompareStringW(LOCALE_USER_DEFAULT, NORM_IGNORENONSPACE, A_NULL_BC, 4, A_ACUTE_BC_DECOMP, 5);
     ok(ret == CSTR_EQUAL, "expected CSTR_EQUAL, got %d\n", ret);
+
+    /* strings sharing a long prefix */
+    ret = CompareStringW(LOCALE_USER_DEFAULT, 0, L"abcdefgh\x301", -1, L"abcdefgh", -1);
+    ok(ret == CSTR_GREATER_THAN, "expected CSTR_GREATER_THAN, got %d\n", ret);
+    ret = CompareStringW(LOCALE_USER_DEFAULT, 0, L"abcdefe\x301", -1, L"abcdef\xe9", -1);
+    ok(ret == CSTR_EQUAL, "expected CSTR_EQUAL, got %d\n", ret);
+    ret = CompareStringW(LOCALE_USER_DEFAULT, 0, L"abcdefghi", -1, L"abcdefghI", -1);
+    ok(ret == CSTR_LESS_THAN, "expected CSTR_LESS_THAN, got %d\n", ret);
+    ret = CompareStringW(LOCALE_USER_DEFAULT, NORM_IGNORECASE, L"abcdefghi", -1, L"abcdefghI", -1);
+    ok(ret == CSTR_EQUAL, "expected CSTR_EQUAL, got %d\n", ret);
+    ret = CompareStringW(LOCALE_USER_DEFAULT, 0, L"co-op-abc", -1, L"coop-abd", -1);
+    ok(ret == CSTR_LESS_THAN, "expected CSTR_LESS_THAN, got %d\n", ret);
+    ret = CompareStringW(LOCALE_USER_DEFAULT, 0, L"abcdefgh-i", -1, L"abcdefghi", -1);
+    ok(ret == CSTR_GREATER_THAN, "expected CSTR_GREATER_THAN, got %d\n", ret);
+    ret = CompareStringW(LOCALE_USER_DEFAULT, SORT_STRINGSORT, L"abcdefgh-i", -1, L"abcdefghi", -1);
+    ok(ret == CSTR_LESS_THAN, "expected CSTR_LESS_THAN, got %d\n", ret);
 }
 
 struct comparestringex_test {
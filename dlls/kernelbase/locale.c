@@ -3863,6 +3863,65 @@ static int get_sortkey( const struct sortguid *sortid, DWORD flags,
 }
 
 
+/* get the number of leading chars that can be skipped when comparing two strings */
+/* the skipped chars contribute the same weights to both strings, and are followed by a
+ * char that doesn't combine with them, so the remaining weights are compared the same way */
+static int get_common_prefix( const struct sortguid *sortid, DWORD flags, UINT except,
+                              const WCHAR *src1, const WCHAR *src2, int len, UINT *primary_len )
+{
+    union char_weights weights;
+    UINT primary = 0;
+    int i, ret = 0;
+
+    /* reversed diacritics would put the skipped weights at the end of the key */
+    if (sortid->flags & FLAG_REVERSEDIACRITICS) return 0;
+
+    for (i = 0; i < len && src1[i] == src2[i]; i++)
+    {
+        weights = get_char_weights( src1[i], except );
+        if (weights._case & CASE_COMPR_6) break;
+
+        switch (weights.script)
+        {
+        case SCRIPT_UNSORTABLE:
+        case SCRIPT_NONSPACE_MARK:
+            continue;
+        case SCRIPT_PUNCTUATION:
+            if (flags & NORM_IGNORESYMBOLS) continue;
+            if (!(flags & SORT_STRINGSORT)) continue;  /* only adds special weights */
+            primary += 2;
+            continue;
+        case SCRIPT_SYMBOL_1:
+        case SCRIPT_SYMBOL_2:
+        case SCRIPT_SYMBOL_3:
+        case SCRIPT_SYMBOL_4:
+        case SCRIPT_SYMBOL_5:
+        case SCRIPT_SYMBOL_6:
+            if (!(flags & NORM_IGNORESYMBOLS)) primary += 2;
+            continue;
+        case SCRIPT_DIGIT:
+            if (flags & SORT_DIGITSASNUMBERS) break;
+            primary += 2;
+            continue;
+        case SCRIPT_EXPANSION:
+        case SCRIPT_EASTASIA_SPECIAL:
+        case SCRIPT_JAMO_SPECIAL:
+        case SCRIPT_EXTENSION_A:
+            break;
+        default:
+            if (weights.script >= SCRIPT_PUA_FIRST) break;
+            /* a plain char adds its own diacritic weight and stops kana
+             * lookups, so the comparison can start from there */
+            ret = i;
+            *primary_len = primary;
+            primary += 2;
+            continue;
+        }
+        break;
+    }
+    return ret;
+}
+
 /* implementation of CompareStringEx */
 static int compare_string( const struct sortguid *sortid, DWORD flags,
                            const WCHAR *src1, int srclen1, const WCHAR *src2, int srclen2 )
@@ -3871,20 +3930,33 @@ static int compare_string( const struct sortguid *sortid, DWORD flags,
     struct sortkey_state s2;
     BYTE primary1[32];
     BYTE primary2[32];
-    int i, ret, len, pos1 = 0, pos2 = 0;
+    int i, ret, len, skip, pos1 = 0, pos2 = 0;
     BOOL have_extra1, have_extra2;
     BYTE case_mask = 0x3f;
     UINT except = sortid->except;
+    UINT primary_pos = 0;
     const WCHAR *compr_tables[8];
 
+    if (srclen1 == srclen2 && !memcmp( src1, src2, srclen1 * sizeof(WCHAR) )) return 0;
+
     compr_tables[0] = NULL;
     if (flags & NORM_IGNORECASE) case_mask &= ~(CASE_UPPER | CASE_SUBSCRIPT);
     if (flags & NORM_IGNOREWIDTH) case_mask &= ~CASE_FULLWIDTH;
     if (flags & NORM_IGNOREKANATYPE) case_mask &= ~CASE_KATAKANA;
     if ((flags & NORM_LINGUISTIC_CASING) && except && sortid->ling_except) except = sortid->ling_except;
 
+    if ((skip = get_common_prefix( sortid, flags, except, src1, src2,
+                                   min( srclen1, srclen2 ), &primary_pos )))
+    {
+        src1 += skip;
+        src2 += skip;
+        srclen1 -= skip;
+        srclen2 -= skip;
+    }
+
     init_sortkey_state( &s1, flags, srclen1, primary1, sizeof(primary1) );
     init_sortkey_state( &s2, flags, srclen2, primary2, sizeof(primary2) );
+    s1.primary_pos = s2.primary_pos = primary_pos;
 
     while (pos1 < srclen1 || pos2 < srclen2)
     {
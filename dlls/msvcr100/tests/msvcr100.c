@@ -169,8 +169,8 @@ struct SchedulerVtbl {
     unsigned int (__thiscall *Release)(Scheduler*);
     void (__thiscall *RegisterShutdownEvent)(Scheduler*,HANDLE);
     void (__thiscall *Attach)(Scheduler*);
-    /* CreateScheduleGroup */
-    /* ScheduleTask */
+    void* (__thiscall *CreateScheduleGroup)(Scheduler*);
+    void (__thiscall *ScheduleTask)(Scheduler*,void (__cdecl*)(void*),void*);
 };
 
 static SpinWait* (__thiscall *pSpinWait_ctor_yield)(SpinWait*, yield_func);
@@ -907,11 +907,41 @@ static void test_ExternalContextBase(void)
     CloseHandle(thread);
 }
 
+struct scheduled_tasks
+{
+    LONG running;
+    LONG max_running;
+    LONG done;
+    HANDLE event;
+};
+
+static void __cdecl scheduled_task_proc(void *arg)
+{
+    struct scheduled_tasks *tasks = arg;
+    LONG running, max;
+
+    running = InterlockedIncrement(&tasks->running);
+    max = tasks->max_running;
+    while (running > max)
+    {
+        LONG prev = InterlockedCompareExchange(&tasks->max_running, running, max);
+        if (prev == max) break;
+        max = prev;
+    }
+    Sleep(1);
+    InterlockedDecrement(&tasks->running);
+
+    if (InterlockedIncrement(&tasks->done) == 64)
+        SetEvent(tasks->event);
+}
+
 static void test_Scheduler(void)
 {
     Scheduler *scheduler, *current_scheduler;
+    struct scheduled_tasks tasks;
     SchedulerPolicy policy;
     unsigned int i;
+    DWORD ret;
 
     call_func1(p_SchedulerPolicy_ctor, &policy);
     scheduler = p_Scheduler_Create(&policy);
@@ -936,6 +966,22 @@ static void test_Scheduler(void)
 
     i = call_func1(scheduler->vtable->GetNumberOfVirtualProcessors, scheduler);
     ok(i == 1, "Scheduler::GetNumberOfVirtualProcessors() = %u\n", i);
+    call_func1(scheduler->vtable->Release, scheduler);
+
+    call_func3(p_SchedulerPolicy_SetConcurrencyLimits, &policy, 1, 2);
+    scheduler = p_Scheduler_Create(&policy);
+    ok(scheduler != NULL, "Scheduler::Create() = NULL\n");
+
+    memset(&tasks, 0, sizeof(tasks));
+    tasks.event = CreateEventW(NULL, TRUE, FALSE, NULL);
+    for (i = 0; i < 64; i++)
+        call_func3(scheduler->vtable->ScheduleTask, scheduler, scheduled_task_proc, &tasks);
+    ret = WaitForSingleObject(tasks.event, 5000);
+    ok(ret == WAIT_OBJECT_0, "WaitForSingleObject returned %ld\n", ret);
+    ok(tasks.done == 64, "%ld tasks executed\n", tasks.done);
+    ok(tasks.max_running <= 2, "%ld tasks were running at the same time\n", tasks.max_running);
+    CloseHandle(tasks.event);
+
     call_func1(scheduler->vtable->Release, scheduler);
     call_func1(p_SchedulerPolicy_dtor, &policy);
 }
@@ -104,6 +104,8 @@ struct beacon {
     struct _StructuredTaskCollection *task_collection;
 };
 
+struct scheduler_workers;
+
 typedef struct {
     Context context;
     struct scheduler_list scheduler;
@@ -113,6 +115,9 @@ typedef struct {
     struct _StructuredTaskCollection *task_collection;
     CRITICAL_SECTION beacons_cs;
     struct list beacons;
+    struct scheduler_workers *workers;
+    unsigned int vproc;
+    BOOL oversubscribed;
 } ExternalContextBase;
 extern const vtable_ptr ExternalContextBase_vtable;
 static void ExternalContextBase_ctor(ExternalContextBase*);
@@ -155,9 +160,43 @@ typedef struct {
     HANDLE *shutdown_events;
     CRITICAL_SECTION cs;
     struct list scheduled_chores;
+    struct scheduler_workers *workers;
 } ThreadScheduler;
 extern const vtable_ptr ThreadScheduler_vtable;
 
+struct scheduler_task {
+    struct list entry;
+    void (__cdecl *proc)(void*);
+    void *data;
+    ThreadScheduler *scheduler;
+};
+
+/* task queue of a virtual processor; the owning worker takes tasks from
+ * the head, idle workers of the same scheduler steal them from the tail */
+struct virtual_processor {
+    CRITICAL_SECTION cs;
+    struct list tasks;
+};
+
+/* worker threads of a ThreadScheduler, kept separately so that they can
+ * outlive the scheduler object */
+struct scheduler_workers {
+    LONG ref;
+    LONG shutdown;
+    LONG queued;        /* number of tasks in all queues */
+    LONG running;       /* number of workers that are not blocked */
+    LONG idle;          /* number of workers waiting for tasks */
+    LONG started;
+    LONG next_vproc;
+    LONG next_home;
+    LONG min_running;
+    LONG max_running;
+    SIZE_T stack_size;
+    int priority;
+    unsigned int vproc_count;
+    struct virtual_processor vprocs[1];
+};
+
 typedef struct {
     Scheduler *scheduler;
 } _Scheduler;
@@ -440,6 +479,9 @@ static SchedulerPolicy default_scheduler_policy;
 static ThreadScheduler *default_scheduler;
 
 static void create_default_scheduler(void);
+static BOOL scheduler_workers_claim(struct scheduler_workers*);
+static void scheduler_workers_block(struct scheduler_workers*);
+static void scheduler_workers_shutdown(struct scheduler_workers*);
 
 /* ??0improper_lock@Concurrency@@QAE@PBD@Z */
 /* ??0improper_lock@Concurrency@@QEAA@PEBD@Z */
@@ -975,11 +1017,19 @@ void __thiscall ExternalContextBase_Block(ExternalContextBase *this)
     TRACE("(%p)->()\n", this);
 
     blocked = InterlockedIncrement(&this->blocked);
+    if (blocked < 1)
+        return;
+
+    if (this->workers && !this->oversubscribed)
+        scheduler_workers_block(this->workers);
     while (blocked >= 1)
     {
         RtlWaitOnAddress(&this->blocked, &blocked, sizeof(LONG), NULL);
         blocked = this->blocked;
     }
+    /* the worker keeps running uncounted if its slot was taken meanwhile */
+    if (this->workers)
+        this->oversubscribed = !scheduler_workers_claim(this->workers);
 }
 
 DEFINE_THISCALL_WRAPPER(ExternalContextBase_Yield, 4)
@@ -1405,6 +1455,7 @@ static void ThreadScheduler_dtor(ThreadScheduler *this)
 
     if(this->ref != 0) WARN("ref = %ld\n", this->ref);
     SchedulerPolicy_dtor(&this->policy);
+    scheduler_workers_shutdown(this->workers);
 
     for(i=0; i<this->shutdown_count; i++)
         SetEvent(this->shutdown_events[i]);
@@ -1527,66 +1578,281 @@ DEFINE_THISCALL_WRAPPER(ThreadScheduler_CreateScheduleGroup, 4)
     return NULL;
 }
 
-typedef struct
+void __cdecl CurrentScheduler_Detach(void);
+
+static struct scheduler_workers *scheduler_workers_create(const SchedulerPolicy *policy,
+        unsigned int vproc_count)
+{
+    struct scheduler_workers *workers;
+    unsigned int i;
+
+    workers = operator_new(offsetof(struct scheduler_workers, vprocs[vproc_count]));
+    memset(workers, 0, offsetof(struct scheduler_workers, vprocs));
+    workers->ref = 1;
+    workers->max_running = vproc_count;
+    workers->min_running = min(SchedulerPolicy_GetPolicyValue(policy, MinConcurrency), vproc_count);
+    workers->stack_size = (SIZE_T)SchedulerPolicy_GetPolicyValue(policy, ContextStackSize) * 1024;
+    workers->priority = SchedulerPolicy_GetPolicyValue(policy, ContextPriority);
+    workers->vproc_count = vproc_count;
+
+    for(i=0; i<vproc_count; i++) {
+        InitializeCriticalSectionEx(&workers->vprocs[i].cs, 0, RTL_CRITICAL_SECTION_FLAG_FORCE_DEBUG_INFO);
+        workers->vprocs[i].cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": virtual_processor");
+        list_init(&workers->vprocs[i].tasks);
+    }
+    return workers;
+}
+
+static void scheduler_workers_release(struct scheduler_workers *workers)
 {
-    void (__cdecl *proc)(void*);
-    void *data;
-    ThreadScheduler *scheduler;
-} schedule_task_arg;
+    struct scheduler_task *task, *next;
+    unsigned int i;
 
-void __cdecl CurrentScheduler_Detach(void);
+    if(InterlockedDecrement(&workers->ref))
+        return;
 
-static void WINAPI schedule_task_proc(PTP_CALLBACK_INSTANCE instance, void *context, PTP_WORK work)
+    for(i=0; i<workers->vproc_count; i++) {
+        LIST_FOR_EACH_ENTRY_SAFE(task, next, &workers->vprocs[i].tasks,
+                struct scheduler_task, entry)
+            operator_delete(task);
+        workers->vprocs[i].cs.DebugInfo->Spare[0] = 0;
+        DeleteCriticalSection(&workers->vprocs[i].cs);
+    }
+    operator_delete(workers);
+}
+
+static void scheduler_workers_shutdown(struct scheduler_workers *workers)
+{
+    workers->shutdown = TRUE;
+    RtlWakeAddressAll(&workers->queued);
+    scheduler_workers_release(workers);
+}
+
+static struct scheduler_task *scheduler_workers_pop(struct scheduler_workers *workers,
+        unsigned int home)
+{
+    struct virtual_processor *vproc;
+    struct list *entry = NULL;
+    unsigned int i;
+
+    /* take the most recently queued task from the own queue first, then
+     * steal the oldest task from the queues of other virtual processors */
+    for(i=0; i<workers->vproc_count && !entry; i++) {
+        vproc = &workers->vprocs[(home + i) % workers->vproc_count];
+        if(list_empty(&vproc->tasks))
+            continue;
+
+        EnterCriticalSection(&vproc->cs);
+        entry = i ? list_tail(&vproc->tasks) : list_head(&vproc->tasks);
+        if(entry)
+            list_remove(entry);
+        LeaveCriticalSection(&vproc->cs);
+    }
+    if(!entry)
+        return NULL;
+
+    InterlockedDecrement(&workers->queued);
+    return LIST_ENTRY(entry, struct scheduler_task, entry);
+}
+
+static BOOL scheduler_workers_claim(struct scheduler_workers *workers)
 {
-    schedule_task_arg arg;
+    LONG running = workers->running, prev;
+
+    while(running < workers->max_running) {
+        prev = InterlockedCompareExchange(&workers->running, running + 1, running);
+        if(prev == running)
+            return TRUE;
+        running = prev;
+    }
+    return FALSE;
+}
+
+static BOOL scheduler_workers_unclaim(struct scheduler_workers *workers, LONG min)
+{
+    LONG running = workers->running, prev;
+
+    while(running > min) {
+        prev = InterlockedCompareExchange(&workers->running, running - 1, running);
+        if(prev == running)
+            return TRUE;
+        running = prev;
+    }
+    return FALSE;
+}
+
+static void execute_task(struct scheduler_task *task)
+{
+    ThreadScheduler *scheduler = task->scheduler;
+    void (__cdecl *proc)(void*) = task->proc;
+    void *data = task->data;
     BOOL detach = FALSE;
 
-    arg = *(schedule_task_arg*)context;
-    operator_delete(context);
+    operator_delete(task);
 
-    if(&arg.scheduler->scheduler != get_current_scheduler()) {
-        ThreadScheduler_Attach(arg.scheduler);
+    if(&scheduler->scheduler != get_current_scheduler()) {
+        ThreadScheduler_Attach(scheduler);
         detach = TRUE;
     }
-    ThreadScheduler_Release(arg.scheduler);
+    ThreadScheduler_Release(scheduler);
 
-    arg.proc(arg.data);
+    proc(data);
 
     if(detach)
         CurrentScheduler_Detach();
 }
 
+static DWORD WINAPI scheduler_worker_proc(void *arg)
+{
+    struct scheduler_workers *workers = arg;
+    ExternalContextBase *ctx = (ExternalContextBase*)get_current_context();
+    unsigned int home = InterlockedIncrement(&workers->next_home) % workers->vproc_count;
+    struct scheduler_task *task;
+    LARGE_INTEGER timeout;
+    BOOL timed_out;
+    LONG zero = 0;
+    HMODULE module;
+
+    TRACE("(%p) starting on virtual processor %u\n", workers, home);
+
+    ctx->workers = workers;
+    ctx->vproc = home;
+
+    timeout.QuadPart = (ULONGLONG)5000 * -10000;
+    for(;;) {
+        /* exit once the current task is done if no running slot is free */
+        if(ctx->oversubscribed) {
+            if(!scheduler_workers_claim(workers))
+                break;
+            ctx->oversubscribed = FALSE;
+        }
+
+        if((task = scheduler_workers_pop(workers, home))) {
+            execute_task(task);
+            continue;
+        }
+
+        timed_out = FALSE;
+        InterlockedIncrement(&workers->idle);
+        if(!workers->queued && !workers->shutdown)
+            timed_out = RtlWaitOnAddress(&workers->queued, &zero, sizeof(zero), &timeout) == STATUS_TIMEOUT;
+        InterlockedDecrement(&workers->idle);
+        if(workers->queued || (!timed_out && !workers->shutdown))
+            continue;
+
+        /* keep min_running workers around until the scheduler shuts down */
+        if(!scheduler_workers_unclaim(workers, workers->shutdown ? 0 : workers->min_running))
+            continue;
+        /* tasks may have been queued while no worker was counted as running */
+        if(!workers->queued || !scheduler_workers_claim(workers))
+            break;
+    }
+
+    TRACE("(%p) exiting\n", workers);
+
+    ctx->workers = NULL;
+    ctx->oversubscribed = FALSE;
+    scheduler_workers_release(workers);
+
+    if(!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS |
+                GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                (const WCHAR*)scheduler_worker_proc, &module))
+        return 0;
+    FreeLibraryAndExitThread(module, 0);
+}
+
+/* must be called with a running slot claimed for the new worker */
+static BOOL scheduler_workers_spawn(struct scheduler_workers *workers)
+{
+    HMODULE module;
+    HANDLE thread;
+
+    /* keep the dll loaded as long as the worker is alive */
+    if(!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS,
+                (const WCHAR*)scheduler_worker_proc, &module)) {
+        InterlockedDecrement(&workers->running);
+        return FALSE;
+    }
+
+    InterlockedIncrement(&workers->ref);
+    thread = CreateThread(NULL, workers->stack_size, scheduler_worker_proc,
+            workers, STACK_SIZE_PARAM_IS_A_RESERVATION, NULL);
+    if(!thread) {
+        WARN("failed to create worker thread: %lu\n", GetLastError());
+        InterlockedDecrement(&workers->ref);
+        InterlockedDecrement(&workers->running);
+        FreeLibrary(module);
+        return FALSE;
+    }
+
+    if(workers->priority != THREAD_PRIORITY_NORMAL)
+        SetThreadPriority(thread, workers->priority);
+    CloseHandle(thread);
+    return TRUE;
+}
+
+static void scheduler_workers_wake(struct scheduler_workers *workers)
+{
+    if(workers->idle)
+        RtlWakeAddressSingle(&workers->queued);
+    else if(scheduler_workers_claim(workers))
+        scheduler_workers_spawn(workers);
+}
+
+static void scheduler_workers_block(struct scheduler_workers *workers)
+{
+    /* let another worker run the queued tasks while this one is blocked */
+    InterlockedDecrement(&workers->running);
+    if(workers->queued)
+        scheduler_workers_wake(workers);
+}
+
+static void scheduler_workers_push(struct scheduler_workers *workers,
+        struct scheduler_task *task)
+{
+    ExternalContextBase *ctx = (ExternalContextBase*)try_get_current_context();
+    struct virtual_processor *vproc;
+    LONG i;
+
+    if(ctx && ctx->context.vtable == &ExternalContextBase_vtable &&
+            ctx->workers == workers) {
+        vproc = &workers->vprocs[ctx->vproc];
+        EnterCriticalSection(&vproc->cs);
+        list_add_head(&vproc->tasks, &task->entry);
+        LeaveCriticalSection(&vproc->cs);
+    } else {
+        i = InterlockedIncrement(&workers->next_vproc);
+        vproc = &workers->vprocs[(ULONG)i % workers->vproc_count];
+        EnterCriticalSection(&vproc->cs);
+        list_add_tail(&vproc->tasks, &task->entry);
+        LeaveCriticalSection(&vproc->cs);
+    }
+    InterlockedIncrement(&workers->queued);
+
+    if(!workers->started && !InterlockedExchange(&workers->started, TRUE)) {
+        for(i=0; i<workers->min_running; i++) {
+            if(!scheduler_workers_claim(workers) || !scheduler_workers_spawn(workers))
+                break;
+        }
+    }
+    scheduler_workers_wake(workers);
+}
+
 DEFINE_THISCALL_WRAPPER(ThreadScheduler_ScheduleTask_loc, 16)
 void __thiscall ThreadScheduler_ScheduleTask_loc(ThreadScheduler *this,
         void (__cdecl *proc)(void*), void* data, /*location*/void *placement)
 {
-    static unsigned int once;
-    schedule_task_arg *arg;
-    TP_WORK *work;
+    struct scheduler_task *task;
 
-    if(!once++)
-        FIXME("(%p %p %p %p) semi-stub\n", this, proc, data, placement);
-    else
-        TRACE("(%p %p %p %p) semi-stub\n", this, proc, data, placement);
+    TRACE("(%p %p %p %p)\n", this, proc, data, placement);
 
-    arg = operator_new(sizeof(*arg));
-    arg->proc = proc;
-    arg->data = data;
-    arg->scheduler = this;
+    task = operator_new(sizeof(*task));
+    task->proc = proc;
+    task->data = data;
+    task->scheduler = this;
     ThreadScheduler_Reference(this);
 
-    work = CreateThreadpoolWork(schedule_task_proc, arg, NULL);
-    if(!work) {
-        scheduler_resource_allocation_error e;
-
-        ThreadScheduler_Release(this);
-        operator_delete(arg);
-        scheduler_resource_allocation_error_ctor_name(&e, NULL,
-                HRESULT_FROM_WIN32(GetLastError()));
-        _CxxThrowException(&e, &scheduler_resource_allocation_error_exception_type);
-    }
-    SubmitThreadpoolWork(work);
-    CloseThreadpoolWork(work);
+    scheduler_workers_push(this->workers, task);
 }
 
 DEFINE_THISCALL_WRAPPER(ThreadScheduler_ScheduleTask, 12)
@@ -1649,6 +1915,7 @@ static ThreadScheduler* ThreadScheduler_ctor(ThreadScheduler *this,
     this->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": ThreadScheduler");
 
     list_init(&this->scheduled_chores);
+    this->workers = scheduler_workers_create(&this->policy, this->virt_proc_no);
     return this;
 }
 
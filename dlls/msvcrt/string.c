@@ -1559,13 +1559,30 @@ int CDECL _atoldbl(_LDOUBLE *value, char *str)
     return _atoldbl_l( value, str, NULL );
 }
 
+/* The string functions below scan the data a word at a time. Words are
+ * read from aligned addresses, so that the reads never cross a page
+ * boundary past the end of the string. */
+#define WORD_MASK  (sizeof(uint64_t) - 1)
+#define BYTES_LOW  0x0101010101010101ull
+#define BYTES_HIGH 0x8080808080808080ull
+
+static inline BOOL has_zero_byte(uint64_t v)
+{
+    return ((v - BYTES_LOW) & ~v & BYTES_HIGH) != 0;
+}
+
 /*********************************************************************
  *              strlen (MSVCRT.@)
  */
 size_t __cdecl strlen(const char *str)
 {
-    const char *s = str;
-    while (*s) s++;
+    const uint64_t *w;
+    const char *s;
+
+    for (s = str; (uintptr_t)s & WORD_MASK; s++)
+        if (!*s) return s - str;
+    for (w = (const uint64_t *)s; !has_zero_byte(*w); w++) ;
+    for (s = (const char *)w; *s; s++) ;
     return s - str;
 }
 
@@ -1576,7 +1593,11 @@ size_t CDECL strnlen(const char *s, size_t maxlen)
 {
     size_t i;
 
-    for(i=0; i<maxlen; i++)
+    for(i=0; i<maxlen && ((uintptr_t)(s+i) & WORD_MASK); i++)
+        if(!s[i]) return i;
+    for(; maxlen-i >= sizeof(uint64_t); i+=sizeof(uint64_t))
+        if(has_zero_byte(*(const uint64_t *)(s+i))) break;
+    for(; i<maxlen; i++)
         if(!s[i]) break;
 
     return i;
@@ -3249,6 +3270,22 @@ void *__cdecl memset(void *dst, int c, size_t n)
  */
 char* __cdecl strchr(const char *str, int c)
 {
+    uint64_t v = BYTES_LOW * (unsigned char)c, w;
+    const uint64_t *p;
+
+    for (; (uintptr_t)str & WORD_MASK; str++)
+    {
+        if (*str == (char)c) return (char*)str;
+        if (!*str) return NULL;
+    }
+
+    for (p = (const uint64_t *)str; ; p++)
+    {
+        w = *p;
+        if (has_zero_byte(w) || has_zero_byte(w ^ v)) break;
+    }
+
+    str = (const char *)p;
     do
     {
         if (*str == (char)c) return (char*)str;
@@ -3271,9 +3308,14 @@ char* __cdecl strrchr(const char *str, int c)
  */
 void* __cdecl memchr(const void *ptr, int c, size_t n)
 {
+    uint64_t v = BYTES_LOW * (unsigned char)c;
     const unsigned char *p = ptr;
 
-    for (p = ptr; n; n--, p++) if (*p == (unsigned char)c) return (void *)(ULONG_PTR)p;
+    for (; n && ((uintptr_t)p & WORD_MASK); n--, p++)
+        if (*p == (unsigned char)c) return (void *)(ULONG_PTR)p;
+    for (; n >= sizeof(uint64_t); n -= sizeof(uint64_t), p += sizeof(uint64_t))
+        if (has_zero_byte(*(const uint64_t *)p ^ v)) break;
+    for (; n; n--, p++) if (*p == (unsigned char)c) return (void *)(ULONG_PTR)p;
     return NULL;
 }
 
@@ -3282,6 +3324,31 @@ void* __cdecl memchr(const void *ptr, int c, size_t n)
  */
 int __cdecl strcmp(const char *str1, const char *str2)
 {
+    typedef uint64_t DECLSPEC_ALIGN(1) unaligned_ui64;
+    uint64_t w;
+    size_t i;
+
+    while (((uintptr_t)str1 & WORD_MASK) && *str1 && *str1 == *str2) { str1++; str2++; }
+
+    /* str1 is read in aligned words, str2 may only be read a word at a time
+     * if the word doesn't cross a page boundary */
+    while (!((uintptr_t)str1 & WORD_MASK))
+    {
+        if (((uintptr_t)str2 & 0xfff) > 0x1000 - sizeof(uint64_t))
+        {
+            for (i = 0; i < sizeof(uint64_t); i++)
+                if (!str1[i] || str1[i] != str2[i]) break;
+            if (i < sizeof(uint64_t)) break;
+        }
+        else
+        {
+            w = *(const uint64_t *)str1;
+            if (has_zero_byte(w) || w != *(const unaligned_ui64 *)str2) break;
+        }
+        str1 += sizeof(uint64_t);
+        str2 += sizeof(uint64_t);
+    }
+
     while (*str1 && *str1 == *str2) { str1++; str2++; }
     if ((unsigned char)*str1 > (unsigned char)*str2) return 1;
     if ((unsigned char)*str1 < (unsigned char)*str2) return -1;
@@ -3411,7 +3478,13 @@ char* __cdecl strstr(const char *haystack, const char *needle)
                 return (char*)haystack + i - j;
             j = lps[j-1];
         }
-        else if (haystack[i]) i++;
+        else
+        {
+            /* skip to the next possible match */
+            const char *next = strchr(haystack + i, needle[0]);
+            if (!next) return NULL;
+            i = next - haystack;
+        }
     }
     return NULL;
 }
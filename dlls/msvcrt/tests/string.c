@@ -4645,6 +4645,63 @@ static void test_wcscmp(void)
     ok(!r, "wcscmp returned %d\n", r);
 }
 
+static void test_page_boundary(void)
+{
+    char *mem, *str, buf[64];
+    WCHAR *wstr, wbuf[32];
+    DWORD prot;
+    size_t len;
+    char *p;
+    int r;
+
+    /* string functions must not read past the terminator into the next page */
+    mem = VirtualAlloc(NULL, 0x2000, MEM_COMMIT, PAGE_READWRITE);
+    ok(mem != NULL, "VirtualAlloc failed\n");
+    ok(VirtualProtect(mem + 0x1000, 0x1000, PAGE_NOACCESS, &prot), "VirtualProtect failed\n");
+
+    for (len = 0; len < ARRAY_SIZE(buf); len++)
+    {
+        str = mem + 0x1000 - len - 1;
+        memset(str, 'a', len);
+        str[len] = 0;
+        memset(buf, 'a', len);
+        buf[len] = 0;
+
+        ok(strlen(str) == len, "%Iu) strlen returned %Iu\n", len, strlen(str));
+        if (p_strnlen)
+            ok(p_strnlen(str, 128) == len, "%Iu) strnlen returned %Iu\n", len, p_strnlen(str, 128));
+        p = strchr(str, 'b');
+        ok(!p, "%Iu) strchr returned %p\n", len, p);
+        p = strchr(str, 0);
+        ok(p == str + len, "%Iu) strchr returned %p, expected %p\n", len, p, str + len);
+        p = memchr(str, 0, len + 1);
+        ok(p == str + len, "%Iu) memchr returned %p, expected %p\n", len, p, str + len);
+        r = strcmp(str, buf);
+        ok(!r, "%Iu) strcmp returned %d\n", len, r);
+        r = len ? strcmp(buf + 1, str) : -1;
+        ok(r == -1, "%Iu) strcmp returned %d\n", len, r);
+        p = strstr(str, "ab");
+        ok(!p, "%Iu) strstr returned %p\n", len, p);
+
+        if (len >= ARRAY_SIZE(wbuf)) continue;
+        wstr = (WCHAR *)(mem + 0x1000) - len - 1;
+        wcsncpy(wbuf, L"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", len);
+        wbuf[len] = 0;
+        memcpy(wstr, wbuf, (len + 1) * sizeof(WCHAR));
+
+        ok(wcslen(wstr) == len, "%Iu) wcslen returned %Iu\n", len, wcslen(wstr));
+        ok(wcsnlen(wstr, 128) == len, "%Iu) wcsnlen returned %Iu\n", len, wcsnlen(wstr, 128));
+        ok(!wcschr(wstr, 'b'), "%Iu) wcschr returned %p\n", len, wcschr(wstr, 'b'));
+        ok(wcschr(wstr, 0) == wstr + len, "%Iu) wcschr returned %p\n", len, wcschr(wstr, 0));
+        r = wcscmp(wstr, wbuf);
+        ok(!r, "%Iu) wcscmp returned %d\n", len, r);
+        r = len ? wcscmp(wbuf + 1, wstr) : -1;
+        ok(r == -1, "%Iu) wcscmp returned %d\n", len, r);
+    }
+
+    VirtualFree(mem, 0, MEM_RELEASE);
+}
+
 static const char* debugstr_ldouble(_LDOUBLE *v)
 {
     static char buf[2 * ARRAY_SIZE(v->ld) + 1];
@@ -5181,6 +5238,7 @@ START_TEST(string)
     test_strstr();
     test_iswdigit();
     test_wcscmp();
+    test_page_boundary();
     test___STRINGTOLD();
     test_SpecialCasing();
     test__mbbtype();
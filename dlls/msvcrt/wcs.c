@@ -1963,11 +1963,53 @@ int WINAPIV _swprintf_p_l(wchar_t *buffer, size_t length,
     return r;
 }
 
+/* Like the string.c functions, the wide char functions below scan aligned
+ * words when the strings are suitably aligned. */
+#define WORD_MASK   (sizeof(uint64_t) - 1)
+#define WCHARS_LOW  0x0001000100010001ull
+#define WCHARS_HIGH 0x8000800080008000ull
+
+static inline BOOL has_zero_wchar(uint64_t v)
+{
+    return ((v - WCHARS_LOW) & ~v & WCHARS_HIGH) != 0;
+}
+
 /*********************************************************************
  *              wcscmp (MSVCRT.@)
  */
 int CDECL wcscmp(const wchar_t *str1, const wchar_t *str2)
 {
+    typedef uint64_t DECLSPEC_ALIGN(2) unaligned_ui64;
+    uint64_t w;
+    size_t i;
+
+    if (!(((uintptr_t)str1 | (uintptr_t)str2) & 1))
+    {
+        while (((uintptr_t)str1 & WORD_MASK) && *str1 && *str1 == *str2)
+        {
+            str1++;
+            str2++;
+        }
+
+        /* str2 may only be read a word at a time if the word doesn't cross a page */
+        while (!((uintptr_t)str1 & WORD_MASK))
+        {
+            if (((uintptr_t)str2 & 0xfff) > 0x1000 - sizeof(uint64_t))
+            {
+                for (i = 0; i < sizeof(uint64_t) / sizeof(wchar_t); i++)
+                    if (!str1[i] || str1[i] != str2[i]) break;
+                if (i < sizeof(uint64_t) / sizeof(wchar_t)) break;
+            }
+            else
+            {
+                w = *(const uint64_t *)str1;
+                if (has_zero_wchar(w) || w != *(const unaligned_ui64 *)str2) break;
+            }
+            str1 += sizeof(uint64_t) / sizeof(wchar_t);
+            str2 += sizeof(uint64_t) / sizeof(wchar_t);
+        }
+    }
+
     while (*str1 && (*str1 == *str2))
     {
         str1++;
@@ -2907,9 +2949,17 @@ __msvcrt_ulong __cdecl wcstoul(const wchar_t *s, wchar_t **end, int base)
  */
 size_t CDECL wcsnlen(const wchar_t *s, size_t maxlen)
 {
-    size_t i;
+    size_t i = 0;
 
-    for (i = 0; i < maxlen; i++)
+    if (!((uintptr_t)s & 1))
+    {
+        for (; i < maxlen && ((uintptr_t)(s + i) & WORD_MASK); i++)
+            if (!s[i]) return i;
+        for (; maxlen - i >= sizeof(uint64_t) / sizeof(wchar_t); i += sizeof(uint64_t) / sizeof(wchar_t))
+            if (has_zero_wchar(*(const uint64_t *)(s + i))) break;
+    }
+
+    for (; i < maxlen; i++)
         if (!s[i]) break;
     return i;
 }
@@ -2951,6 +3001,25 @@ wint_t CDECL towupper(wint_t c)
  */
 wchar_t* CDECL wcschr(const wchar_t *str, wchar_t ch)
 {
+    uint64_t v = WCHARS_LOW * ch, w;
+    const uint64_t *p;
+
+    if (!((uintptr_t)str & 1))
+    {
+        for (; (uintptr_t)str & WORD_MASK; str++)
+        {
+            if (*str == ch) return (WCHAR *)(ULONG_PTR)str;
+            if (!*str) return NULL;
+        }
+
+        for (p = (const uint64_t *)str; ; p++)
+        {
+            w = *p;
+            if (has_zero_wchar(w) || has_zero_wchar(w ^ v)) break;
+        }
+        str = (const wchar_t *)p;
+    }
+
     do { if (*str == ch) return (WCHAR *)(ULONG_PTR)str; } while (*str++);
     return NULL;
 }
@@ -2971,6 +3040,16 @@ wchar_t* CDECL wcsrchr(const wchar_t *str, wchar_t ch)
 size_t CDECL wcslen(const wchar_t *str)
 {
     const wchar_t *s = str;
+    const uint64_t *w;
+
+    if (!((uintptr_t)s & 1))
+    {
+        for (; (uintptr_t)s & WORD_MASK; s++)
+            if (!*s) return s - str;
+        for (w = (const uint64_t *)s; !has_zero_wchar(*w); w++) ;
+        s = (const wchar_t *)w;
+    }
+
     while (*s) s++;
     return s - str;
 }
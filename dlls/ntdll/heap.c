@@ -138,6 +138,7 @@ C_ASSERT( sizeof(ARENA_LARGE) == 4 * BLOCK_ALIGN );
 #define BLOCK_TYPE_DEAD        'D'
 #define BLOCK_TYPE_FREE        'F'
 #define BLOCK_TYPE_LARGE       'L'
+#define BLOCK_TYPE_CACHED      'M'
 
 #define BLOCK_FILL_USED        0xbaadf00d
 #define BLOCK_FILL_TAIL        0xab
@@ -260,6 +261,10 @@ struct bin
     LONG count_freed;
     LONG enabled;
 
+    /* LFH statistics counters, only maintained when heap statistics are enabled */
+    LONG count_lfh_alloc;
+    LONG count_lfh_freed;
+
     /* list of groups with free blocks */
     SLIST_HEADER groups;
 
@@ -276,6 +281,24 @@ static inline struct group **bin_get_affinity_group( struct bin *bin, BYTE affin
     return bin->affinity_group_base + affinity * BLOCK_SIZE_BIN_COUNT;
 }
 
+#define MAGAZINE_COUNT      64  /* number of per-thread magazines of a heap */
+#define MAGAZINE_BIN_COUNT   8  /* number of smallest bins cached in the magazines */
+#define MAGAZINE_DEPTH      16  /* number of blocks cached per bin */
+
+/* a per-thread cache of freed LFH blocks, in front of the LFH groups.
+ *
+ * Only the owning thread adds blocks or takes them out, while other threads may
+ * drain the magazine with the heap lock held, so the block slots are always
+ * exchanged atomically when taking a block out. The cached blocks stay allocated
+ * in their group, with the BLOCK_TYPE_CACHED type.
+ */
+struct DECLSPEC_ALIGN(64) magazine
+{
+    LONG owner;                       /* id of the owning thread, 0 if unused */
+    UINT count[MAGAZINE_BIN_COUNT];   /* number of used slots, only accessed by the owner */
+    struct block *blocks[MAGAZINE_BIN_COUNT][MAGAZINE_DEPTH];
+};
+
 struct heap
 {                                  /* win32/win64 */
     DWORD_PTR        unknown1[2];   /* 0000/0000 */
@@ -300,6 +323,11 @@ struct heap
     RTL_CRITICAL_SECTION cs;
     struct entry     free_lists[FREE_LIST_COUNT];
     struct bin      *bins;
+    struct magazine *magazines;     /* Array of MAGAZINE_COUNT per-thread magazines */
+    ULONG            commit_count;  /* Number of subheap commits */
+    ULONG            decommit_count; /* Number of subheap decommits */
+    ULONG            lock_contention; /* Number of contended locks, when statistics are enabled */
+    LONGLONG         lock_wait_time; /* Time spent waiting for the lock, in performance counter ticks */
     SUBHEAP          subheap;
 };
 
@@ -318,6 +346,8 @@ C_ASSERT( HEAP_MIN_LARGE_BLOCK_SIZE <= HEAP_INITIAL_GROW_SIZE );
 
 #define MAX_FREE_PENDING     1024    /* max number of free requests to delay */
 
+#define HEAP_LOCK_SPIN_COUNT 4000    /* spin count of the heap locks, same as Windows */
+
 /* some undocumented flags (names are made up) */
 #define HEAP_PRIVATE          0x00001000
 #define HEAP_ADD_USER_INFO    0x00000100
@@ -330,7 +360,11 @@ C_ASSERT( HEAP_MIN_LARGE_BLOCK_SIZE <= HEAP_INITIAL_GROW_SIZE );
 
 static struct heap *process_heap;  /* main process heap */
 
+static BOOL heap_stats_enabled;        /* maintain optional statistics counters, set with WINEHEAPSTATS */
+static ULONG heap_stats_interval;      /* interval between statistics reports, in ms */
+
 static NTSTATUS heap_free_block_lfh( struct heap *heap, ULONG flags, struct block *block );
+static void heap_drain_magazines( struct heap *heap, ULONG flags );
 
 /* check if memory range a contains memory range b */
 static inline BOOL contains( const void *a, SIZE_T a_size, const void *b, SIZE_T b_size )
@@ -584,8 +618,18 @@ static inline ULONG heap_get_flags( const struct heap *heap, ULONG flags )
 
 static inline void heap_lock( struct heap *heap, ULONG flags )
 {
+    LARGE_INTEGER start, end;
+
     if (flags & HEAP_NO_SERIALIZE) return;
-    RtlEnterCriticalSection( &heap->cs );
+    if (!heap_stats_enabled) RtlEnterCriticalSection( &heap->cs );
+    else if (!RtlTryEnterCriticalSection( &heap->cs ))
+    {
+        RtlQueryPerformanceCounter( &start );
+        RtlEnterCriticalSection( &heap->cs );
+        RtlQueryPerformanceCounter( &end );
+        heap->lock_contention++;
+        heap->lock_wait_time += end.QuadPart - start.QuadPart;
+    }
 }
 
 static inline void heap_unlock( struct heap *heap, ULONG flags )
@@ -746,6 +790,126 @@ static void heap_dump( const struct heap *heap )
     }
 }
 
+static void heap_stats_init(void)
+{
+    static const WCHAR nameW[] = L"WINEHEAPSTATS";
+    WCHAR buffer[16];
+    SIZE_T len;
+
+    if (RtlQueryEnvironmentVariable( NULL, nameW, ARRAY_SIZE(nameW) - 1, buffer, ARRAY_SIZE(buffer) - 1, &len ))
+        return;
+    buffer[len] = 0;
+
+    /* WINEHEAPSTATS=n additionally reports the statistics of all heaps every n seconds */
+    heap_stats_enabled = TRUE;
+    heap_stats_interval = wcstoul( buffer, NULL, 10 ) * 1000;
+}
+
+static void heap_stats_report( const struct heap *heap )
+{
+    LARGE_INTEGER freq;
+    unsigned int i;
+
+    RtlQueryPerformanceFrequency( &freq );
+    MESSAGE( "wine: heap %p: commits %lu, decommits %lu, lock contention %lu, lock wait %I64u ms\n", heap,
+             ReadNoFence( (LONG *)&heap->commit_count ), ReadNoFence( (LONG *)&heap->decommit_count ),
+             ReadNoFence( (LONG *)&heap->lock_contention ), heap->lock_wait_time * 1000 / freq.QuadPart );
+
+    for (i = 0; heap->bins && i < BLOCK_SIZE_BIN_COUNT; i++)
+    {
+        const struct bin *bin = heap->bins + i;
+        ULONG alloc = ReadNoFence( &bin->count_alloc ), freed = ReadNoFence( &bin->count_freed );
+        ULONG lfh_alloc = ReadNoFence( &bin->count_lfh_alloc ), lfh_freed = ReadNoFence( &bin->count_lfh_freed );
+        if (!alloc && !freed && !lfh_alloc && !lfh_freed) continue;
+        MESSAGE( "wine:   bin %3u: size %#6Ix, alloc %lu, freed %lu, lfh alloc %lu, lfh freed %lu, enabled %lu\n",
+                 i, BLOCK_BIN_SIZE( i ), alloc, freed, lfh_alloc, lfh_freed, ReadNoFence( &bin->enabled ) );
+    }
+}
+
+static void CALLBACK heap_stats_timer_callback( TP_CALLBACK_INSTANCE *instance, void *context, TP_TIMER *timer )
+{
+    struct heap *heap;
+
+    RtlEnterCriticalSection( &process_heap->cs );
+
+    heap_stats_report( process_heap );
+    LIST_FOR_EACH_ENTRY( heap, &process_heap->entry, struct heap, entry )
+        heap_stats_report( heap );
+
+    RtlLeaveCriticalSection( &process_heap->cs );
+}
+
+/* start reporting the statistics of all heaps periodically, once the process is initialized */
+void heap_stats_start_report(void)
+{
+    LARGE_INTEGER timeout;
+    TP_TIMER *timer;
+
+    if (!heap_stats_interval) return;
+    if (TpAllocTimer( &timer, heap_stats_timer_callback, NULL, NULL )) return;
+    timeout.QuadPart = (LONGLONG)heap_stats_interval * -10000;
+    TpSetTimer( timer, &timeout, heap_stats_interval, 0 );
+}
+
+static NTSTATUS heap_get_statistics( struct heap *heap, ULONG flags, WINE_HEAP_STATISTICS_INFORMATION *info,
+                                     SIZE_T size_in, SIZE_T *size_out )
+{
+    ULONG i, bin_count = heap->bins ? BLOCK_SIZE_BIN_COUNT : 0;
+    SIZE_T size = offsetof( WINE_HEAP_STATISTICS_INFORMATION, Bins ) + bin_count * sizeof(info->Bins[0]);
+    const struct block *block;
+    const ARENA_LARGE *large;
+    const SUBHEAP *subheap;
+    LARGE_INTEGER freq;
+
+    if (size_out) *size_out = size;
+    if (size_in < size) return STATUS_BUFFER_TOO_SMALL;
+
+    memset( info, 0, size );
+    info->Size = size;
+    info->Enabled = heap_stats_enabled;
+
+    heap_lock( heap, flags );
+
+    LIST_FOR_EACH_ENTRY( subheap, &heap->subheap_list, SUBHEAP, entry )
+    {
+        info->SubheapCount++;
+        info->CommittedSize += (char *)subheap_commit_end( subheap ) - (char *)subheap_base( subheap );
+        for (block = first_block( subheap ); block; block = next_block( subheap, block ))
+        {
+            if (block_get_flags( block ) & BLOCK_FLAG_FREE) info->FreeSize += block_get_size( block );
+            else info->UsedSize += block_get_size( block );
+        }
+    }
+
+    LIST_FOR_EACH_ENTRY( large, &heap->large_list, ARENA_LARGE, entry )
+    {
+        info->LargeCount++;
+        info->LargeSize += large->block_size;
+    }
+
+    info->CommitCount = heap->commit_count;
+    info->DecommitCount = heap->decommit_count;
+    info->LockContentionCount = heap->lock_contention;
+    RtlQueryPerformanceFrequency( &freq );
+    info->LockWaitTime = heap->lock_wait_time * 10000000 / freq.QuadPart;
+
+    heap_unlock( heap, flags );
+
+    info->BinCount = bin_count;
+    for (i = 0; i < bin_count; i++)
+    {
+        const struct bin *bin = heap->bins + i;
+        info->Bins[i].BlockSize = BLOCK_BIN_SIZE( i );
+        info->Bins[i].AllocCount = ReadNoFence( &bin->count_alloc );
+        info->Bins[i].FreeCount = ReadNoFence( &bin->count_freed );
+        info->Bins[i].LfhAllocCount = ReadNoFence( &bin->count_lfh_alloc );
+        info->Bins[i].LfhFreeCount = ReadNoFence( &bin->count_lfh_freed );
+        info->Bins[i].LfhEnabled = !!ReadNoFence( &bin->enabled );
+    }
+
+    return STATUS_SUCCESS;
+}
+
 static const char *debugstr_heap_entry( struct rtl_heap_entry *entry )
 {
     const char *str = wine_dbg_sprintf( "data %p, size %#Ix, overhead %#x, region %#x, flags %#x", entry->lpData,
@@ -800,7 +964,7 @@ static SUBHEAP *find_subheap( const struct heap *heap, const struct block *block
 }
 
 
-static inline BOOL subheap_commit( const struct heap *heap, SUBHEAP *subheap, const struct block *block, SIZE_T block_size )
+static inline BOOL subheap_commit( struct heap *heap, SUBHEAP *subheap, const struct block *block, SIZE_T block_size )
 {
     const char *end = (char *)subheap_base( subheap ) + subheap_size( subheap ), *commit_end;
     SIZE_T size;
@@ -822,11 +986,12 @@ static inline BOOL subheap_commit( const struct heap *heap, SUBHEAP *subheap, co
         return FALSE;
     }
 
+    heap->commit_count++;
     subheap->data_size = (char *)commit_end - (char *)(subheap + 1);
     return TRUE;
 }
 
-static inline BOOL subheap_decommit( const struct heap *heap, SUBHEAP *subheap, const void *commit_end )
+static inline BOOL subheap_decommit( struct heap *heap, SUBHEAP *subheap, const void *commit_end )
 {
     char *base = subheap_base( subheap );
     SIZE_T size;
@@ -845,6 +1010,7 @@ static inline BOOL subheap_decommit( const struct heap *heap, SUBHEAP *subheap,
         return FALSE;
     }
 
+    heap->decommit_count++;
     subheap->data_size = (char *)commit_end - (char *)(subheap + 1);
     return TRUE;
 }
@@ -1380,7 +1546,7 @@ static inline struct block *unsafe_block_from_ptr( struct heap *heap, ULONG flag
         err = "invalid ptr alignment";
     else if (block_get_type( block ) == BLOCK_TYPE_DEAD)
         err = "delayed freed block";
-    else if (block_get_type( block ) == BLOCK_TYPE_FREE)
+    else if (block_get_type( block ) == BLOCK_TYPE_FREE || block_get_type( block ) == BLOCK_TYPE_CACHED)
         err = "already freed block";
     else if (block_get_flags( block ) & BLOCK_FLAG_LFH)
     {
@@ -1549,12 +1715,12 @@ HANDLE WINAPI RtlCreateHeap( ULONG flags, void *addr, SIZE_T total_size, SIZE_T
         heap->cs.RecursionCount = 0;
         heap->cs.OwningThread   = 0;
         heap->cs.LockSemaphore  = 0;
-        heap->cs.SpinCount      = 0;
+        heap->cs.SpinCount      = NtCurrentTeb()->Peb->NumberOfProcessors > 1 ? HEAP_LOCK_SPIN_COUNT : 0;
         process_heap_cs_debug.CriticalSection = &heap->cs;
     }
     else
     {
-        RtlInitializeCriticalSectionEx( &heap->cs, 0, RTL_CRITICAL_SECTION_FLAG_FORCE_DEBUG_INFO );
+        RtlInitializeCriticalSectionEx( &heap->cs, HEAP_LOCK_SPIN_COUNT, RTL_CRITICAL_SECTION_FLAG_FORCE_DEBUG_INFO );
         heap->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": heap.cs");
     }
 
@@ -1594,6 +1760,7 @@ HANDLE WINAPI RtlCreateHeap( ULONG flags, void *addr, SIZE_T total_size, SIZE_T
     {
         process_heap = heap;  /* assume the first heap we create is the process main heap */
         list_init( &process_heap->entry );
+        heap_stats_init();
     }
 
     return heap;
@@ -1633,6 +1800,10 @@ HANDLE WINAPI RtlDestroyHeap( HANDLE handle )
     }
     if (!heap) return handle;
 
+    heap_lock( heap, heap_flags );
+    heap_drain_magazines( heap, heap_flags );
+    heap_unlock( heap, heap_flags );
+
     if ((pending = heap->pending_free))
     {
         heap->pending_free = NULL;
@@ -1676,6 +1847,11 @@ HANDLE WINAPI RtlDestroyHeap( HANDLE handle )
         size = 0;
         NtFreeVirtualMemory( NtCurrentProcess(), &addr, &size, MEM_RELEASE );
     }
+    if ((addr = heap->magazines))
+    {
+        size = 0;
+        NtFreeVirtualMemory( NtCurrentProcess(), &addr, &size, MEM_RELEASE );
+    }
     size = 0;
     addr = heap;
     NtFreeVirtualMemory( NtCurrentProcess(), &addr, &size, MEM_RELEASE );
@@ -1918,10 +2094,66 @@ static struct block *find_free_bin_block( struct heap *heap, ULONG flags, SIZE_T
     return block;
 }
 
+/* return the magazine of the current thread, registering it on first use */
+static struct magazine *heap_get_magazine( struct heap *heap, ULONG flags, SIZE_T bin )
+{
+    LONG tid = HandleToULong( NtCurrentTeb()->ClientId.UniqueThread );
+    struct magazine *magazines, *magazine;
+    SIZE_T size;
+
+    if (bin >= MAGAZINE_BIN_COUNT) return NULL;
+    /* unserialized callers don't expect other threads to drain, checked blocks must be marked free */
+    if (flags & (HEAP_NO_SERIALIZE | HEAP_CHECKING_ENABLED)) return NULL;
+
+    if (!(magazines = ReadPointerAcquire( (void **)&heap->magazines )))
+    {
+        size = sizeof(*magazines) * MAGAZINE_COUNT;
+        if (NtAllocateVirtualMemory( NtCurrentProcess(), (void **)&magazines, 0, &size, MEM_COMMIT, PAGE_READWRITE ))
+            return NULL;
+        if (InterlockedCompareExchangePointer( (void **)&heap->magazines, magazines, NULL ))
+        {
+            size = 0;
+            NtFreeVirtualMemory( NtCurrentProcess(), (void **)&magazines, &size, MEM_RELEASE );
+            magazines = heap->magazines;
+        }
+    }
+
+    /* thread ids are multiples of 4 */
+    magazine = magazines + (tid / 4) % MAGAZINE_COUNT;
+    if (ReadNoFence( &magazine->owner ) == tid) return magazine;
+    if (ReadNoFence( &magazine->owner ) || InterlockedCompareExchange( &magazine->owner, tid, 0 )) return NULL;
+    return magazine;
+}
+
+static struct block *magazine_pop_block( struct magazine *magazine, SIZE_T bin )
+{
+    struct block *block;
+
+    while (magazine->count[bin])
+    {
+        /* the slot may have been emptied by heap_drain_magazines */
+        if ((block = InterlockedExchangePointer( (void **)&magazine->blocks[bin][--magazine->count[bin]], NULL )))
+            return block;
+    }
+
+    return NULL;
+}
+
+static BOOL magazine_push_block( struct magazine *magazine, SIZE_T bin, struct block *block )
+{
+    if (magazine->count[bin] == MAGAZINE_DEPTH) return FALSE;
+
+    block_set_type( block, BLOCK_TYPE_CACHED );
+    /* paired with InterlockedExchangePointer in magazine_drain */
+    WritePointerRelease( (void **)&magazine->blocks[bin][magazine->count[bin]++], block );
+    return TRUE;
+}
+
 static NTSTATUS heap_allocate_block_lfh( struct heap *heap, ULONG flags, SIZE_T block_size,
                                          SIZE_T size, void **ret )
 {
     struct bin *bin, *last = heap->bins + BLOCK_SIZE_BIN_COUNT - 1;
+    struct magazine *magazine;
     struct block *block;
 
     bin = heap->bins + BLOCK_SIZE_BIN( block_size );
@@ -1932,7 +2164,11 @@ static NTSTATUS heap_allocate_block_lfh( struct heap *heap, ULONG flags, SIZE_T
 
     block_size = BLOCK_BIN_SIZE( BLOCK_SIZE_BIN( block_size ) );
 
-    if ((block = find_free_bin_block( heap, flags, block_size, bin )))
+    if (!(magazine = heap_get_magazine( heap, flags, bin - heap->bins )) ||
+        !(block = magazine_pop_block( magazine, bin - heap->bins )))
+        block = find_free_bin_block( heap, flags, block_size, bin );
+
+    if (block)
     {
         block_set_type( block, BLOCK_TYPE_USED );
         block_set_flags( block, (BYTE)~BLOCK_FLAG_LFH, BLOCK_USER_FLAGS( flags ) );
@@ -1940,23 +2176,19 @@ static NTSTATUS heap_allocate_block_lfh( struct heap *heap, ULONG flags, SIZE_T
         initialize_block( block, 0, size, flags );
         mark_block_tail( block, flags );
         *ret = block + 1;
+        if (heap_stats_enabled) InterlockedIncrement( &bin->count_lfh_alloc );
     }
 
     return block ? STATUS_SUCCESS : STATUS_NO_MEMORY;
 }
 
-static NTSTATUS heap_free_block_lfh( struct heap *heap, ULONG flags, struct block *block )
+/* release a block to its group, marking it as free */
+static NTSTATUS bin_free_block( struct heap *heap, ULONG flags, struct bin *bin, struct block *block )
 {
-    struct bin *bin, *last = heap->bins + BLOCK_SIZE_BIN_COUNT - 1;
     SIZE_T i, block_size = block_get_size( block );
     struct group *group = block_get_group( block );
     NTSTATUS status = STATUS_SUCCESS;
 
-    if (!(block_get_flags( block ) & BLOCK_FLAG_LFH)) return STATUS_UNSUCCESSFUL;
-
-    bin = heap->bins + BLOCK_SIZE_BIN( block_size );
-    if (bin == last) return STATUS_UNSUCCESSFUL;
-
     i = block_get_group_index( block );
     valgrind_make_writable( block, sizeof(*block) );
     block_set_type( block, BLOCK_TYPE_FREE );
@@ -1974,6 +2206,55 @@ static NTSTATUS heap_free_block_lfh( struct heap *heap, ULONG flags, struct bloc
     return status;
 }
 
+static NTSTATUS heap_free_block_lfh( struct heap *heap, ULONG flags, struct block *block )
+{
+    struct bin *bin, *last = heap->bins + BLOCK_SIZE_BIN_COUNT - 1;
+    struct magazine *magazine;
+
+    if (!(block_get_flags( block ) & BLOCK_FLAG_LFH)) return STATUS_UNSUCCESSFUL;
+
+    bin = heap->bins + BLOCK_SIZE_BIN( block_get_size( block ) );
+    if (bin == last) return STATUS_UNSUCCESSFUL;
+
+    if (heap_stats_enabled) InterlockedIncrement( &bin->count_lfh_freed );
+
+    if ((magazine = heap_get_magazine( heap, flags, bin - heap->bins )) &&
+        magazine_push_block( magazine, bin - heap->bins, block ))
+        return STATUS_SUCCESS;
+
+    return bin_free_block( heap, flags, bin, block );
+}
+
+/* release the cached blocks of a magazine to their groups */
+static void magazine_drain( struct heap *heap, ULONG flags, struct magazine *magazine )
+{
+    struct block *block;
+    UINT i, j;
+
+    for (i = 0; i < MAGAZINE_BIN_COUNT; i++)
+    {
+        for (j = 0; j < MAGAZINE_DEPTH; j++)
+        {
+            if (!(block = InterlockedExchangePointer( (void **)&magazine->blocks[i][j], NULL ))) continue;
+            bin_free_block( heap, flags, heap->bins + i, block );
+        }
+    }
+}
+
+/* release the cached blocks of every thread, so that the heap can be inspected.
+ * The heap must be locked while calling this function.
+ */
+static void heap_drain_magazines( struct heap *heap, ULONG flags )
+{
+    struct magazine *magazines;
+    UINT i;
+
+    if (!(magazines = ReadPointerAcquire( (void **)&heap->magazines ))) return;
+
+    for (i = 0; i < MAGAZINE_COUNT; i++)
+        if (ReadNoFence( &magazines[i].owner )) magazine_drain( heap, flags, magazines + i );
+}
+
 static void bin_try_enable( struct heap *heap, struct bin *bin )
 {
     ULONG alloc = ReadNoFence( &bin->count_alloc ), freed = ReadNoFence( &bin->count_freed );
@@ -2003,12 +2284,29 @@ static void bin_try_enable( struct heap *heap, struct bin *bin )
     WriteRelease( &bin->enabled, TRUE );
 }
 
+static void heap_thread_detach_magazine( struct heap *heap )
+{
+    LONG tid = HandleToULong( NtCurrentTeb()->ClientId.UniqueThread );
+    struct magazine *magazine;
+
+    if (!heap->magazines) return;
+
+    magazine = heap->magazines + (tid / 4) % MAGAZINE_COUNT;
+    if (ReadNoFence( &magazine->owner ) != tid) return;
+
+    magazine_drain( heap, heap->flags, magazine );
+    memset( magazine->count, 0, sizeof(magazine->count) );
+    WriteRelease( &magazine->owner, 0 );
+}
+
 static void heap_thread_detach_bin_groups( struct heap *heap )
 {
     ULONG i, affinity = NtCurrentTeb()->HeapVirtualAffinity;
 
     if (!heap->bins) return;
 
+    heap_thread_detach_magazine( heap );
+
     for (i = 0; i < BLOCK_SIZE_BIN_COUNT; ++i)
     {
         struct bin *bin = heap->bins + i;
@@ -2282,7 +2580,17 @@ void *WINAPI RtlReAllocateHeap( HANDLE handle, ULONG flags, void *ptr, SIZE_T si
 ULONG WINAPI RtlCompactHeap( HANDLE handle, ULONG flags )
 {
     static BOOL reported;
+    struct heap *heap;
+    ULONG heap_flags;
+
     if (!reported++) FIXME( "handle %p, flags %#lx stub!\n", handle, flags );
+
+    if ((heap = unsafe_heap_from_handle( handle, flags, &heap_flags )))
+    {
+        heap_lock( heap, heap_flags );
+        heap_drain_magazines( heap, heap_flags );
+        heap_unlock( heap, heap_flags );
+    }
     return 0;
 }
 
@@ -2305,6 +2613,7 @@ BOOLEAN WINAPI RtlLockHeap( HANDLE handle )
     ULONG heap_flags;
     if (!(heap = unsafe_heap_from_handle( handle, 0, &heap_flags ))) return FALSE;
     heap_lock( heap, heap_flags );
+    heap_drain_magazines( heap, heap_flags );
     return TRUE;
 }
 
@@ -2385,6 +2694,7 @@ BOOLEAN WINAPI RtlValidateHeap( HANDLE handle, ULONG flags, const void *ptr )
     else
     {
         heap_lock( heap, heap_flags );
+        heap_drain_magazines( heap, heap_flags );
         if (ptr) ret = heap_validate_ptr( heap, ptr );
         else ret = heap_validate( heap );
         heap_unlock( heap, heap_flags );
@@ -2513,6 +2823,7 @@ NTSTATUS WINAPI RtlWalkHeap( HANDLE handle, void *entry_ptr )
     else
     {
         heap_lock( heap, heap_flags );
+        heap_drain_magazines( heap, heap_flags );
         status = heap_walk( heap, entry );
         heap_unlock( heap, heap_flags );
     }
@@ -2573,6 +2884,10 @@ NTSTATUS WINAPI RtlQueryHeapInformation( HANDLE handle, HEAP_INFORMATION_CLASS i
         *(ULONG *)info = ReadNoFence( &heap->compat_info );
         return STATUS_SUCCESS;
 
+    case HeapWineStatisticsInformation:
+        if (!(heap = unsafe_heap_from_handle( handle, 0, &flags ))) return STATUS_ACCESS_VIOLATION;
+        return heap_get_statistics( heap, flags, info, size_in, size_out );
+
     default:
         FIXME( "HEAP_INFORMATION_CLASS %u not implemented!\n", info_class );
         return STATUS_INVALID_INFO_CLASS;
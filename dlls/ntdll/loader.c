@@ -98,6 +98,7 @@ static UNICODE_STRING system_dll_path; /* path to search for system dependency d
 static DWORD default_search_flags;  /* default flags set by LdrSetDefaultDllDirectories */
 static WCHAR *default_load_path;    /* default dll search path */
 static HANDLE known_dlls_ntdir;  /* NT directory containing known dlls sections */
+static ULONG max_loader_threads = 1;  /* number of threads used for prefetching imports */
 
 struct dll_dir_entry
 {
@@ -133,6 +134,13 @@ struct file_id
 #define HASH_MAP_SIZE 32
 static LIST_ENTRY hash_table[HASH_MAP_SIZE];
 
+/* hash index of the exported names of a module */
+struct export_index
+{
+    DWORD                 mask;      /* table size - 1 */
+    DWORD                 slots[1];  /* index in the names table + 1, or 0 if unused */
+};
+
 /* internal representation of loaded modules */
 typedef struct _wine_modref
 {
@@ -140,8 +148,12 @@ typedef struct _wine_modref
     struct file_id        id;
     ULONG                 CheckSum;
     BOOL                  system;
+    struct export_index  *export_index;  /* lazily built index of exported names */
 } WINE_MODREF;
 
+/* minimum number of exported names for building an export index */
+#define EXPORT_INDEX_MIN_NAMES 64
+
 static UINT tls_module_count = 32;     /* number of modules with TLS directory */
 static IMAGE_TLS_DIRECTORY *tls_dirs;  /* array of TLS directories */
 
@@ -191,11 +203,14 @@ static WINE_MODREF *last_failed_modref;
 static LDR_DDAG_NODE *node_ntdll, *node_kernel32;
 
 static NTSTATUS load_dll( const WCHAR *load_path, const WCHAR *libname, DWORD flags, WINE_MODREF** pwm, BOOL system );
+static void prefetch_imports( WINE_MODREF *wm, const IMAGE_IMPORT_DESCRIPTOR *imports, int count, LPCWSTR load_path );
+static void discard_prefetched_dlls( WINE_MODREF *wm );
+static void stop_prefetch_workers(void);
 static NTSTATUS process_attach( LDR_DDAG_NODE *node, LPVOID lpReserved );
 static FARPROC find_ordinal_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY *exports,
                                     DWORD exp_size, DWORD ordinal, LPCWSTR load_path,
                                     WINE_MODREF *importer, BOOL is_dynamic );
-static FARPROC find_named_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY *exports, DWORD exp_size,
+static FARPROC find_named_export( WINE_MODREF *wm, const IMAGE_EXPORT_DIRECTORY *exports, DWORD exp_size,
                                   const char *name, int hint, LPCWSTR load_path,
                                   WINE_MODREF *importer, BOOL is_dynamic );
 
@@ -997,7 +1012,7 @@ static FARPROC find_forwarded_export( HMODULE module, const char *forward, LPCWS
                                         atoi(name+1) - exports->Base, load_path,
                                         importer, is_dynamic );
         } else
-            proc = find_named_export( wm->ldr.DllBase, exports, exp_size, name, -1, load_path,
+            proc = find_named_export( wm, exports, exp_size, name, -1, load_path,
                                       importer, is_dynamic );
     }
 
@@ -1077,16 +1092,83 @@ static int find_name_in_exports( HMODULE module, const IMAGE_EXPORT_DIRECTORY *e
 }
 
 
+static inline DWORD hash_export_name( const char *name )
+{
+    DWORD hash = 0x811c9dc5;
+
+    while (*name) hash = (hash ^ (unsigned char)*name++) * 0x01000193;
+    return hash;
+}
+
+
+/*************************************************************************
+ *		build_export_index
+ *
+ * Build the hash index of the exported names of a module.
+ * The loader_section must be locked while calling this function.
+ */
+static struct export_index *build_export_index( HMODULE module, const IMAGE_EXPORT_DIRECTORY *exports )
+{
+    const DWORD *names = get_rva( module, exports->AddressOfNames );
+    struct export_index *index;
+    DWORD i, size = 1;
+
+    while (size < 2 * exports->NumberOfNames) size <<= 1;
+
+    if (!(index = RtlAllocateHeap( GetProcessHeap(), HEAP_ZERO_MEMORY,
+                                   offsetof( struct export_index, slots[size] ) )))
+        return NULL;
+    index->mask = size - 1;
+
+    for (i = 0; i < exports->NumberOfNames; i++)
+    {
+        DWORD pos = hash_export_name( get_rva( module, names[i] ) ) & index->mask;
+
+        while (index->slots[pos]) pos = (pos + 1) & index->mask;
+        index->slots[pos] = i + 1;
+    }
+    return index;
+}
+
+
+/*************************************************************************
+ *		find_name_in_export_index
+ *
+ * Helper for find_named_export.
+ * The loader_section must be locked while calling this function.
+ */
+static int find_name_in_export_index( WINE_MODREF *wm, const IMAGE_EXPORT_DIRECTORY *exports, const char *name )
+{
+    HMODULE module = wm->ldr.DllBase;
+    const WORD *ordinals = get_rva( module, exports->AddressOfNameOrdinals );
+    const DWORD *names = get_rva( module, exports->AddressOfNames );
+    struct export_index *index;
+    DWORD pos;
+
+    if (exports->NumberOfNames < EXPORT_INDEX_MIN_NAMES) return -1;
+    if (!(index = wm->export_index) && !(index = wm->export_index = build_export_index( module, exports )))
+        return -1;
+
+    for (pos = hash_export_name( name ) & index->mask; index->slots[pos]; pos = (pos + 1) & index->mask)
+    {
+        DWORD i = index->slots[pos] - 1;
+        if (i < exports->NumberOfNames && !strcmp( get_rva( module, names[i] ), name )) return ordinals[i];
+    }
+    return -1;
+}
+
+
 /*************************************************************************
  *		find_named_export
  *
  * Find an exported function by name.
  * The loader_section must be locked while calling this function.
  */
-static FARPROC find_named_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY *exports, DWORD exp_size,
+static FARPROC find_named_export( WINE_MODREF *wm, const IMAGE_EXPORT_DIRECTORY *exports, DWORD exp_size,
                                   const char *name, int hint, LPCWSTR load_path, WINE_MODREF *importer,
                                   BOOL is_dynamic )
 {
+    HMODULE module = wm->ldr.DllBase;
     const WORD *ordinals = get_rva( module, exports->AddressOfNameOrdinals );
     const DWORD *names = get_rva( module, exports->AddressOfNames );
     int ordinal;
@@ -1099,8 +1181,10 @@ static FARPROC find_named_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY *
             return find_ordinal_export( module, exports, exp_size, ordinals[hint], load_path, importer, is_dynamic );
     }
 
-    /* then do a binary search */
-    if ((ordinal = find_name_in_exports( module, exports, name )) == -1) return NULL;
+    /* then look it up in the index, falling back to a binary search in case
+     * the index is missing or out of date */
+    if ((ordinal = find_name_in_export_index( wm, exports, name )) == -1 &&
+        (ordinal = find_name_in_exports( module, exports, name )) == -1) return NULL;
     return find_ordinal_export( module, exports, exp_size, ordinal, load_path, importer, is_dynamic );
 
 }
@@ -1242,7 +1326,7 @@ static BOOL import_dll( WINE_MODREF *wm, const IMAGE_IMPORT_DESCRIPTOR *descr, L
         {
             IMAGE_IMPORT_BY_NAME *pe_name;
             pe_name = get_rva( module, (DWORD)import_list->u1.AddressOfData );
-            thunk_list->u1.Function = (ULONG_PTR)find_named_export( imp_mod, exports, exp_size,
+            thunk_list->u1.Function = (ULONG_PTR)find_named_export( wmImp, exports, exp_size,
                                                                     (const char*)pe_name->Name,
                                                                     pe_name->Hint, load_path, wm, FALSE );
             if (!thunk_list->u1.Function)
@@ -1506,6 +1590,9 @@ static NTSTATUS fixup_imports( WINE_MODREF *wm, LPCWSTR load_path )
     if (!create_module_activation_context( &wm->ldr ))
         RtlActivateActivationContext( 0, wm->ldr.ActivationContext, &cookie );
 
+    /* open the files of the imported modules in parallel */
+    prefetch_imports( wm, imports, nb_imports, load_path );
+
     /* load the imported modules. They are automatically
      * added to the modref list of the process.
      */
@@ -1518,6 +1605,7 @@ static NTSTATUS fixup_imports( WINE_MODREF *wm, LPCWSTR load_path )
         else if (imp && imp->ldr.DdagNode != node_ntdll && imp->ldr.DdagNode != node_kernel32)
             add_module_dependency_after( wm->ldr.DdagNode, imp->ldr.DdagNode, dep_after );
     }
+    discard_prefetched_dlls( wm );
     if (wm->ldr.ActivationContext) RtlDeactivateActivationContext( 0, cookie );
     return status;
 }
@@ -2078,7 +2166,7 @@ NTSTATUS WINAPI LdrGetProcedureAddress(HMODULE module, const ANSI_STRING *name,
     else if ((exports = RtlImageDirectoryEntryToData( module, TRUE,
                                                       IMAGE_DIRECTORY_ENTRY_EXPORT, &exp_size )))
     {
-        void *proc = name ? find_named_export( module, exports, exp_size, name->Buffer, -1, NULL, wm, TRUE )
+        void *proc = name ? find_named_export( wm, exports, exp_size, name->Buffer, -1, NULL, wm, TRUE )
                           : find_ordinal_export( module, exports, exp_size, ord - exports->Base, NULL, wm, TRUE );
         if (proc)
         {
@@ -2693,6 +2781,75 @@ static NTSTATUS get_dll_load_path_search_flags( LPCWSTR module, DWORD flags, WCH
  *
  * Open a file for a new dll. Helper for find_dll_file.
  */
+/* image section of a dll opened ahead of time by a loader worker thread */
+struct prefetched_dll
+{
+    struct list                entry;
+    WINE_MODREF               *importer;    /* module whose imports caused the prefetch */
+    const WCHAR               *load_path;
+    BOOL                       system;
+    WCHAR                      libname[256];
+    UNICODE_STRING             nt_name;
+    HANDLE                     mapping;
+    SECTION_IMAGE_INFORMATION  image_info;
+    struct file_id             id;
+};
+
+static struct list prefetched_dlls = LIST_INIT( prefetched_dlls );
+
+static BOOL is_file_id_valid( const struct file_id *id )
+{
+    static const struct file_id zero_id;
+    return memcmp( id, &zero_id, sizeof(zero_id) );
+}
+
+/***********************************************************************
+ *	take_prefetched_dll
+ *
+ * Retrieve the section of a dll that has already been opened by a loader worker thread.
+ * The loader_section must be locked while calling this function.
+ */
+static BOOL take_prefetched_dll( const UNICODE_STRING *nt_name, HANDLE *mapping,
+                                 SECTION_IMAGE_INFORMATION *image_info, struct file_id *id )
+{
+    struct prefetched_dll *dll;
+
+    LIST_FOR_EACH_ENTRY( dll, &prefetched_dlls, struct prefetched_dll, entry )
+    {
+        if (!RtlEqualUnicodeString( nt_name, &dll->nt_name, TRUE )) continue;
+        TRACE( "using prefetched %s\n", debugstr_us(nt_name) );
+        *mapping = dll->mapping;
+        *image_info = dll->image_info;
+        *id = dll->id;
+        list_remove( &dll->entry );
+        RtlFreeUnicodeString( &dll->nt_name );
+        RtlFreeHeap( GetProcessHeap(), 0, dll );
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/***********************************************************************
+ *	discard_prefetched_dlls
+ *
+ * Free the prefetched dlls that were not needed after all.
+ * The loader_section must be locked while calling this function.
+ */
+static void discard_prefetched_dlls( WINE_MODREF *wm )
+{
+    struct prefetched_dll *dll, *next;
+
+    LIST_FOR_EACH_ENTRY_SAFE( dll, next, &prefetched_dlls, struct prefetched_dll, entry )
+    {
+        if (dll->importer != wm) continue;
+        TRACE( "discarding prefetched %s\n", debugstr_us(&dll->nt_name) );
+        list_remove( &dll->entry );
+        NtClose( dll->mapping );
+        RtlFreeUnicodeString( &dll->nt_name );
+        RtlFreeHeap( GetProcessHeap(), 0, dll );
+    }
+}
+
 static NTSTATUS open_dll_file( UNICODE_STRING *nt_name, WINE_MODREF **pwm, HANDLE *mapping,
                                SECTION_IMAGE_INFORMATION *image_info, struct file_id *id )
 {
@@ -2703,8 +2860,26 @@ static NTSTATUS open_dll_file( UNICODE_STRING *nt_name, WINE_MODREF **pwm, HANDL
     FILE_OBJECTID_BUFFER fid;
     NTSTATUS status;
     HANDLE handle;
+    BOOL worker = NtCurrentTeb()->LoaderWorker;
 
-    if ((*pwm = find_fullname_module( nt_name ))) return STATUS_SUCCESS;
+    /* loader worker threads only open files, the loader state is left to the thread owning the loader lock */
+    *pwm = NULL;
+    if (!worker)
+    {
+        if ((*pwm = find_fullname_module( nt_name ))) return STATUS_SUCCESS;
+
+        if (take_prefetched_dll( nt_name, mapping, image_info, id ))
+        {
+            if (is_file_id_valid( id ) && (*pwm = find_fileid_module( id )))
+            {
+                TRACE( "%s is the same file as existing module %p %s\n", debugstr_w( nt_name->Buffer ),
+                       (*pwm)->ldr.DllBase, debugstr_w( (*pwm)->ldr.FullDllName.Buffer ));
+                NtClose( *mapping );
+                *mapping = NULL;
+            }
+            return STATUS_SUCCESS;
+        }
+    }
 
     InitializeObjectAttributes( &attr, nt_name, OBJ_CASE_INSENSITIVE, 0, NULL );
     if ((status = NtOpenFile( &handle, GENERIC_READ | SYNCHRONIZE, &attr, &io,
@@ -2726,7 +2901,7 @@ static NTSTATUS open_dll_file( UNICODE_STRING *nt_name, WINE_MODREF **pwm, HANDL
     {
         memcpy( id->ObjectId, fid.ObjectId, sizeof(id->ObjectId) );
         memcpy( id->BirthVolumeId, fid.BirthVolumeId, sizeof(id->BirthVolumeId) );
-        if ((*pwm = find_fileid_module( id )))
+        if (!worker && (*pwm = find_fileid_module( id )))
         {
             TRACE( "%s is the same file as existing module %p %s\n", debugstr_w( nt_name->Buffer ),
                    (*pwm)->ldr.DllBase, debugstr_w( (*pwm)->ldr.FullDllName.Buffer ));
@@ -3330,6 +3505,237 @@ static NTSTATUS find_dll_file( const WCHAR *load_path, const WCHAR *libname, UNI
 }
 
 
+struct prefetch_context
+{
+    struct prefetched_dll **dlls;
+    unsigned int           count;
+    LONG                   next;
+};
+
+/* minimum number of dlls to search for before using the worker threads */
+#define PREFETCH_MIN_DLLS 4
+
+/* the workers only live while the imports of the process are resolved */
+static HANDLE prefetch_threads[16];
+static unsigned int nb_prefetch_threads;
+static HANDLE prefetch_start;  /* semaphore released once per worker for each batch */
+static HANDLE prefetch_done;   /* semaphore released by the workers when done with a batch */
+static struct prefetch_context *prefetch_ctx;  /* current batch, NULL to stop the workers */
+
+/***********************************************************************
+ *	is_known_dll
+ *
+ * Check if a dll is in the KnownDlls NT directory, without touching the loader state.
+ */
+static BOOL is_known_dll( const WCHAR *libname )
+{
+    UNICODE_STRING str;
+    OBJECT_ATTRIBUTES attr;
+    HANDLE mapping;
+
+    if (!known_dlls_ntdir) return FALSE;
+    RtlInitUnicodeString( &str, libname );
+    InitializeObjectAttributes( &attr, &str, OBJ_CASE_INSENSITIVE, known_dlls_ntdir, NULL );
+    if (NtOpenSection( &mapping, SECTION_QUERY, &attr )) return FALSE;
+    NtClose( mapping );
+    return TRUE;
+}
+
+/***********************************************************************
+ *	prefetch_dll
+ *
+ * Search for a dll file and create its image section, without touching the loader state.
+ */
+static void prefetch_dll( struct prefetched_dll *dll )
+{
+    NTSTATUS status = STATUS_DLL_NOT_FOUND;
+    ULONG wow64_old_value = 0;
+    WINE_MODREF *wm;
+
+    if (dll->system && system_dll_path.Buffer)
+        status = search_dll_file( system_dll_path.Buffer, dll->libname, &dll->nt_name, &wm,
+                                  &dll->mapping, &dll->image_info, &dll->id );
+    /* known dlls are opened from their section by find_dll_file, there is nothing to prefetch */
+    if (status && is_known_dll( dll->libname ))
+        TRACE( "%s is a known dll\n", debugstr_w(dll->libname) );
+    else if (status)
+    {
+        RtlWow64EnableFsRedirectionEx( 0, &wow64_old_value );
+        status = search_dll_file( dll->load_path, dll->libname, &dll->nt_name, &wm,
+                                  &dll->mapping, &dll->image_info, &dll->id );
+        if (wow64_old_value) RtlWow64EnableFsRedirectionEx( 1, &wow64_old_value );
+    }
+    if (status || !dll->mapping)
+    {
+        RtlFreeUnicodeString( &dll->nt_name );
+        dll->mapping = NULL;
+    }
+}
+
+static void run_prefetch_tasks( struct prefetch_context *ctx )
+{
+    LONG i;
+
+    while ((i = InterlockedIncrement( &ctx->next ) - 1) < ctx->count) prefetch_dll( ctx->dlls[i] );
+}
+
+static void WINAPI prefetch_worker( void *arg )
+{
+    struct prefetch_context *ctx;
+
+    NtCurrentTeb()->LoaderWorker = 1;
+    for (;;)
+    {
+        NtWaitForSingleObject( prefetch_start, FALSE, NULL );
+        if (!(ctx = prefetch_ctx)) break;
+        run_prefetch_tasks( ctx );
+        NtReleaseSemaphore( prefetch_done, 1, NULL );
+    }
+    /* don't go through LdrShutdownThread, the loader lock is held by the waiting thread */
+    for (;;) NtTerminateThread( GetCurrentThread(), 0 );
+}
+
+/***********************************************************************
+ *	start_prefetch_workers
+ *
+ * Create the worker threads on first use.
+ * The loader_section must be locked while calling this function.
+ */
+static void start_prefetch_workers(void)
+{
+    unsigned int count = min( max_loader_threads - 1, ARRAY_SIZE(prefetch_threads) );
+
+    if (prefetch_start) return;
+    if (NtCreateSemaphore( &prefetch_start, SEMAPHORE_ALL_ACCESS, NULL, 0, ARRAY_SIZE(prefetch_threads) ))
+        return;
+    if (NtCreateSemaphore( &prefetch_done, SEMAPHORE_ALL_ACCESS, NULL, 0, ARRAY_SIZE(prefetch_threads) ))
+    {
+        NtClose( prefetch_start );
+        prefetch_start = NULL;
+        return;
+    }
+
+    while (nb_prefetch_threads < count)
+    {
+        if (NtCreateThreadEx( &prefetch_threads[nb_prefetch_threads], THREAD_ALL_ACCESS, NULL,
+                              GetCurrentProcess(), prefetch_worker, NULL,
+                              THREAD_CREATE_FLAGS_SKIP_THREAD_ATTACH | THREAD_CREATE_FLAGS_SKIP_LOADER_INIT |
+                              THREAD_CREATE_FLAGS_HIDE_FROM_DEBUGGER, 0, 0, 0, NULL ))
+            break;
+        nb_prefetch_threads++;
+    }
+    TRACE( "started %u loader workers\n", nb_prefetch_threads );
+}
+
+/***********************************************************************
+ *	stop_prefetch_workers
+ *
+ * Terminate the worker threads once the process imports are loaded.
+ * The loader_section must be locked while calling this function.
+ */
+static void stop_prefetch_workers(void)
+{
+    unsigned int i;
+
+    if (!prefetch_start) return;
+
+    prefetch_ctx = NULL;
+    if (nb_prefetch_threads)
+    {
+        NtReleaseSemaphore( prefetch_start, nb_prefetch_threads, NULL );
+        NtWaitForMultipleObjects( nb_prefetch_threads, prefetch_threads, TRUE, FALSE, NULL );
+    }
+    for (i = 0; i < nb_prefetch_threads; i++) NtClose( prefetch_threads[i] );
+    nb_prefetch_threads = 0;
+    NtClose( prefetch_start );
+    NtClose( prefetch_done );
+    prefetch_start = prefetch_done = NULL;
+}
+
+/***********************************************************************
+ *	prefetch_imports
+ *
+ * Search for the files of the imported modules and create their image sections
+ * on worker threads, so that the lookups and the server requests for the
+ * independent dlls run in parallel. The modules are then loaded in order as
+ * usual, using the prefetched sections. This is only done while loading the
+ * imports of the process, and for modules with enough imports to be worth it.
+ * The loader_section must be locked while calling this function.
+ */
+static void prefetch_imports( WINE_MODREF *wm, const IMAGE_IMPORT_DESCRIPTOR *imports, int count,
+                              LPCWSTR load_path )
+{
+    BOOL system = wm->system || (wm->ldr.Flags & LDR_WINE_INTERNAL);
+    struct prefetch_context ctx = { 0 };
+    unsigned int i;
+    USHORT worker;
+
+    if (max_loader_threads <= 1 || imports_fixup_done || count < PREFETCH_MIN_DLLS) return;
+    if (!(ctx.dlls = RtlAllocateHeap( GetProcessHeap(), 0, count * sizeof(*ctx.dlls) ))) return;
+
+    for (i = 0; i < count; i++)
+    {
+        const char *name = get_rva( wm->ldr.DllBase, imports[i].Name );
+        struct prefetched_dll *dll, *other;
+        WCHAR *fullname = NULL;
+        BOOL skip = FALSE;
+        unsigned int j;
+
+        if (!(dll = RtlAllocateHeap( GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*dll) ))) break;
+        /* only prefetch the dlls that would be searched for in the load path */
+        if (build_import_name( wm, dll->libname, name, strlen(name) ) || contains_path( dll->libname ) ||
+            find_apiset_dll( dll->libname, &fullname ) != STATUS_APISET_NOT_PRESENT ||
+            find_actctx_dll( dll->libname, &fullname ) != STATUS_SXS_KEY_NOT_FOUND ||
+            find_basename_module( dll->libname ))
+            skip = TRUE;
+        RtlFreeHeap( GetProcessHeap(), 0, fullname );
+
+        /* skip duplicates and dlls that are already prefetched */
+        for (j = 0; !skip && j < ctx.count; j++)
+            if (!wcsicmp( ctx.dlls[j]->libname, dll->libname )) skip = TRUE;
+        LIST_FOR_EACH_ENTRY( other, &prefetched_dlls, struct prefetched_dll, entry )
+            if (!wcsicmp( other->libname, dll->libname )) skip = TRUE;
+
+        if (skip)
+        {
+            RtlFreeHeap( GetProcessHeap(), 0, dll );
+            continue;
+        }
+        dll->importer = wm;
+        dll->load_path = load_path;
+        dll->system = system;
+        ctx.dlls[ctx.count++] = dll;
+    }
+
+    if (ctx.count >= PREFETCH_MIN_DLLS)
+    {
+        unsigned int nb_threads;
+
+        TRACE( "prefetching %u dlls for %s\n", ctx.count, debugstr_w(wm->ldr.BaseDllName.Buffer) );
+
+        start_prefetch_workers();
+        nb_threads = min( nb_prefetch_threads, ctx.count - 1 );
+        prefetch_ctx = &ctx;
+        if (nb_threads) NtReleaseSemaphore( prefetch_start, nb_threads, NULL );
+
+        worker = NtCurrentTeb()->LoaderWorker;
+        NtCurrentTeb()->LoaderWorker = 1;
+        run_prefetch_tasks( &ctx );
+        NtCurrentTeb()->LoaderWorker = worker;
+
+        for (i = 0; i < nb_threads; i++) NtWaitForSingleObject( prefetch_done, FALSE, NULL );
+        prefetch_ctx = NULL;
+    }
+
+    for (i = 0; i < ctx.count; i++)
+    {
+        if (ctx.dlls[i]->mapping) list_add_tail( &prefetched_dlls, &ctx.dlls[i]->entry );
+        else RtlFreeHeap( GetProcessHeap(), 0, ctx.dlls[i] );
+    }
+    RtlFreeHeap( GetProcessHeap(), 0, ctx.dlls );
+}
+
+
 /***********************************************************************
  *	load_dll  (internal)
  *
@@ -4051,6 +4457,7 @@ static void free_modref( WINE_MODREF *wm )
     NtUnmapViewOfSection( NtCurrentProcess(), wm->ldr.DllBase );
     if (cached_modref == wm) cached_modref = NULL;
     RtlFreeUnicodeString( &wm->ldr.FullDllName );
+    RtlFreeHeap( GetProcessHeap(), 0, wm->export_index );
     RtlFreeHeap( GetProcessHeap(), 0, wm );
 }
 
@@ -4212,6 +4619,10 @@ static void load_global_options(void)
         query_dword_option( hkey, L"SafeDllSearchMode", &dll_safe_mode );
         NtClose( hkey );
     }
+
+    LdrQueryImageFileExecutionOptions( &NtCurrentTeb()->Peb->ProcessParameters->ImagePathName,
+                                       L"MaxLoaderThreads", REG_DWORD, &max_loader_threads,
+                                       sizeof(max_loader_threads), NULL );
 }
 
 static BOOL needs_elevation(void)
@@ -4513,6 +4924,7 @@ void loader_init( CONTEXT *context, void **entry )
             status = fixup_imports_ilonly( wm, NULL, entry );
         else
             status = fixup_imports( wm, NULL );
+        stop_prefetch_workers();
 
         if (status)
         {
@@ -4573,6 +4985,7 @@ void loader_init( CONTEXT *context, void **entry )
             NtTerminateProcess( GetCurrentProcess(), status );
         }
         release_address_space();
+        heap_stats_start_report();
         if (wm->ldr.TlsIndex == -1) call_tls_callbacks( wm->ldr.DllBase, DLL_PROCESS_ATTACH );
         if (wm->ldr.ActivationContext) RtlDeactivateActivationContext( 0, cookie );
 
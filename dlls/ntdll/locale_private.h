@@ -136,6 +136,22 @@ static inline void put_utf16( WCHAR *dst, unsigned int ch )
 }
 
 
+/* check whether the next 8 chars are all 7-bit ASCII */
+static inline BOOL is_ascii_run( const char *str )
+{
+    typedef UINT64 DECLSPEC_ALIGN(1) unaligned_ui64;
+    return !(*(const unaligned_ui64 *)str & 0x8080808080808080ull);
+}
+
+
+/* check whether the next 4 WCHARs are all 7-bit ASCII */
+static inline BOOL is_ascii_runW( const WCHAR *str )
+{
+    typedef UINT64 DECLSPEC_ALIGN(1) unaligned_ui64;
+    return !(*(const unaligned_ui64 *)str & 0xff80ff80ff80ff80ull);
+}
+
+
 static inline unsigned int decode_utf8_char( unsigned char ch, const char **str, const char *strend )
 {
     /* number of following bytes in sequence based on first byte value (for bytes above 0x7f) */
@@ -316,7 +332,16 @@ static inline NTSTATUS utf8_wcstombs_size( const WCHAR *src, unsigned int srclen
 
     for (len = 0; srclen; srclen--, src++)
     {
-        if (*src < 0x80) len++;  /* 0x00-0x7f: 1 byte */
+        if (*src < 0x80)  /* 0x00-0x7f: 1 byte */
+        {
+            len++;
+            while (srclen > 4 && is_ascii_runW( src + 1 ))
+            {
+                len += 4;
+                src += 4;
+                srclen -= 4;
+            }
+        }
         else if (*src < 0x800) len += 2;  /* 0x80-0x7ff: 2 bytes */
         else
         {
@@ -348,7 +373,15 @@ static inline NTSTATUS utf8_mbstowcs_size( const char *src, unsigned int srclen,
     for (len = 0; src < srcend; len++)
     {
         unsigned char ch = *src++;
-        if (ch < 0x80) continue;
+        if (ch < 0x80)
+        {
+            while (srcend - src >= 8 && is_ascii_run( src ))
+            {
+                len += 8;
+                src += 8;
+            }
+            continue;
+        }
         if ((res = decode_utf8_char( ch, &src, srcend )) > 0x10ffff)
             status = STATUS_SOME_NOT_MAPPED;
         else
@@ -422,7 +455,7 @@ static inline unsigned int cp_wcstombs( const CPTABLEINFO *info, char *dst, unsi
 static inline NTSTATUS utf8_mbstowcs( WCHAR *dst, unsigned int dstlen, unsigned int *reslen,
                                       const char *src, unsigned int srclen )
 {
-    unsigned int res;
+    unsigned int res, i;
     NTSTATUS status = STATUS_SUCCESS;
     const char *srcend = src + srclen;
     WCHAR *dstend = dst + dstlen;
@@ -433,6 +466,18 @@ static inline NTSTATUS utf8_mbstowcs( WCHAR *dst, unsigned int dstlen, unsigned
         if (ch < 0x80)  /* special fast case for 7-bit ASCII */
         {
             *dst++ = ch;
+            while (srcend - src >= 8 && dstend - dst >= 8 && is_ascii_run( src ))
+            {
+                for (i = 0; i < 8; i++) dst[i] = (unsigned char)src[i];
+                src += 8;
+                dst += 8;
+            }
+            continue;
+        }
+        /* fast case for well-formed 2-byte sequences */
+        if (ch >= 0xc2 && ch < 0xe0 && src < srcend && (unsigned char)(*src ^ 0x80) < 0x40)
+        {
+            *dst++ = ((ch & 0x1f) << 6) | (*src++ & 0x3f);
             continue;
         }
         if ((res = decode_utf8_char( ch, &src, srcend )) <= 0xffff)
@@ -477,6 +522,16 @@ static inline NTSTATUS utf8_wcstombs( char *dst, unsigned int dstlen, unsigned i
         {
             if (dst > end - 1) break;
             *dst++ = ch;
+            while (srclen > 4 && end - dst >= 4 && is_ascii_runW( src + 1 ))
+            {
+                dst[0] = src[1];
+                dst[1] = src[2];
+                dst[2] = src[3];
+                dst[3] = src[4];
+                dst += 4;
+                src += 4;
+                srclen -= 4;
+            }
             continue;
         }
         if (ch < 0x800)  /* 0x80-0x7ff: 2 bytes */
@@ -70,7 +70,7 @@ DWORD WINAPI RtlRunOnceBeginInitialize( RTL_RUN_ONCE *once, ULONG flags, void **
 
     for (;;)
     {
-        ULONG_PTR next, val = (ULONG_PTR)ReadPointerAcquire( &once->Ptr );
+        ULONG_PTR val = (ULONG_PTR)ReadPointerAcquire( &once->Ptr );
 
         switch (val & 3)
         {
@@ -82,10 +82,7 @@ DWORD WINAPI RtlRunOnceBeginInitialize( RTL_RUN_ONCE *once, ULONG flags, void **
 
         case 1:  /* in progress, wait */
             if (flags & RTL_RUN_ONCE_ASYNC) return STATUS_INVALID_PARAMETER;
-            next = val & ~3;
-            if (InterlockedCompareExchangePointer( &once->Ptr, (void *)((ULONG_PTR)&next | 1),
-                                                   (void *)val ) == (void *)val)
-                NtWaitForKeyedEvent( 0, &next, FALSE, NULL );
+            RtlWaitOnAddress( &once->Ptr, &val, sizeof(val), NULL );
             break;
 
         case 2:  /* done */
@@ -121,13 +118,7 @@ DWORD WINAPI RtlRunOnceComplete( RTL_RUN_ONCE *once, ULONG flags, void *context
         {
         case 1:  /* in progress */
             if (InterlockedCompareExchangePointer( &once->Ptr, context, (void *)val ) != (void *)val) break;
-            val &= ~3;
-            while (val)
-            {
-                ULONG_PTR next = *(ULONG_PTR *)val;
-                NtReleaseKeyedEvent( 0, (void *)val, FALSE, NULL );
-                val = next;
-            }
+            RtlWakeAddressAll( &once->Ptr );
             return STATUS_SUCCESS;
 
         case 3:  /* in progress, async */
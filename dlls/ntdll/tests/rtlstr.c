@@ -2073,6 +2073,11 @@ static const struct unicode_to_utf8_test unicode_to_utf8[] = {
     { { '-',0x00e7,0x0301,'-',0 }, "-\xC3\xA7\xCC\x81-", STATUS_SUCCESS },
     { { '-',0x0063,0x0327,0x0301,'-',0 }, "-\x63\xCC\xA7\xCC\x81-", STATUS_SUCCESS },
     { { '-',0x0063,0x0301,0x0327,'-',0 }, "-\x63\xCC\x81\xCC\xA7-", STATUS_SUCCESS },
+    /* longer runs of ASCII mixed with other chars */
+    { { 'a','b','c','d','e','f','g','h','i','j','k','l',0xe9,'m','n','o','p','q','r','s','t','u','v',0 },
+      "abcdefghijkl\xC3\xA9mnopqrstuv", STATUS_SUCCESS },
+    { { 'a','b','c','d','e','f','g','h',0xdc00,'a','b','c','d','e','f','g','h',0xd83d,0xde00,0 },
+      "abcdefgh\xEF\xBF\xBD""abcdefgh\xF0\x9F\x98\x80", STATUS_SOME_NOT_MAPPED },
 };
 
 static void utf8_expect_(const unsigned char *out_string, ULONG buflen, ULONG out_bytes,
@@ -2406,6 +2411,11 @@ static const struct utf8_to_unicode_test utf8_to_unicode[] = {
     { "-\xC3\xA7\xCC\x81-", { '-',0x00e7,0x0301,'-',0 }, STATUS_SUCCESS },
     { "-\x63\xCC\xA7\xCC\x81-", { '-',0x0063,0x0327,0x0301,'-',0 }, STATUS_SUCCESS },
     { "-\x63\xCC\x81\xCC\xA7-", { '-',0x0063,0x0301,0x0327,'-',0 }, STATUS_SUCCESS },
+    /* longer runs of ASCII mixed with other chars */
+    { "abcdefghijkl\xC3\xA9mnopqrstuv\xD0\x96\xD0\x96", { 'a','b','c','d','e','f','g','h','i','j','k','l',
+      0xe9,'m','n','o','p','q','r','s','t','u','v',0x416,0x416,0 }, STATUS_SUCCESS },
+    { "abcdefgh\x80""abcdefgh\xC3", { 'a','b','c','d','e','f','g','h',0xfffd,
+      'a','b','c','d','e','f','g','h',0xfffd,0 }, STATUS_SOME_NOT_MAPPED },
 };
 
 static void unicode_expect_(const WCHAR *out_string, ULONG buflen, ULONG out_chars,
@@ -838,6 +838,93 @@ static void test_tp_work_scheduler(void)
     pTpReleasePool(pool);
 }
 
+struct submit_info
+{
+    TP_CALLBACK_ENVIRON *environment;
+    TP_WORK *work;
+    LONG simple_count;
+    LONG work_count;
+};
+
+static void CALLBACK submit_simple_cb(TP_CALLBACK_INSTANCE *instance, void *userdata)
+{
+    struct submit_info *info = userdata;
+    InterlockedIncrement(&info->simple_count);
+}
+
+static void CALLBACK submit_work_cb(TP_CALLBACK_INSTANCE *instance, void *userdata, TP_WORK *work)
+{
+    struct submit_info *info = userdata;
+    InterlockedIncrement(&info->work_count);
+}
+
+static DWORD WINAPI submit_thread(void *arg)
+{
+    struct submit_info *info = arg;
+    NTSTATUS status;
+    int i;
+
+    for (i = 0; i < 1000; i++)
+    {
+        status = pTpSimpleTryPost(submit_simple_cb, info, info->environment);
+        ok(!status, "TpSimpleTryPost failed with status %lx\n", status);
+        pTpPostWork(info->work);
+    }
+    return 0;
+}
+
+static void test_tp_concurrent_submit(void)
+{
+    TP_CALLBACK_ENVIRON environment;
+    struct submit_info info;
+    TP_CLEANUP_GROUP *group;
+    HANDLE threads[4];
+    NTSTATUS status;
+    TP_POOL *pool;
+    int i;
+
+    pool = NULL;
+    status = pTpAllocPool(&pool, NULL);
+    ok(!status, "TpAllocPool failed with status %lx\n", status);
+    pTpSetPoolMaxThreads(pool, 8);
+
+    group = NULL;
+    status = pTpAllocCleanupGroup(&group);
+    ok(!status, "TpAllocCleanupGroup failed with status %lx\n", status);
+
+    memset(&environment, 0, sizeof(environment));
+    environment.Version = 1;
+    environment.Pool = pool;
+    environment.CleanupGroup = group;
+
+    info.environment = &environment;
+    info.simple_count = 0;
+    info.work_count = 0;
+    info.work = NULL;
+    status = pTpAllocWork(&info.work, submit_work_cb, &info, &environment);
+    ok(!status, "TpAllocWork failed with status %lx\n", status);
+
+    /* submit callbacks from several threads at once */
+    for (i = 0; i < ARRAY_SIZE(threads); i++)
+    {
+        threads[i] = CreateThread(NULL, 0, submit_thread, &info, 0, NULL);
+        ok(threads[i] != NULL, "CreateThread failed %lu\n", GetLastError());
+    }
+    for (i = 0; i < ARRAY_SIZE(threads); i++)
+    {
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+    }
+
+    pTpWaitForWork(info.work, FALSE);
+    pTpReleaseCleanupGroupMembers(group, FALSE, NULL);
+    ok(info.simple_count == 4000, "got %lu simple callbacks\n", info.simple_count);
+    ok(info.work_count == 4000, "got %lu work callbacks\n", info.work_count);
+
+    pTpReleaseCleanupGroup(group);
+    pTpReleasePool(pool);
+}
+
 static void CALLBACK simple_release_cb(TP_CALLBACK_INSTANCE *instance, void *userdata)
 {
     HANDLE *semaphores = userdata;
@@ -2484,6 +2571,7 @@ START_TEST(threadpool)
     test_tp_simple();
     test_tp_work();
     test_tp_work_scheduler();
+    test_tp_concurrent_submit();
     test_tp_group_wait();
     test_tp_group_cancel();
     test_tp_instance();
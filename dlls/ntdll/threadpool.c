@@ -96,8 +96,17 @@ struct timer_queue
  */
 
 #define THREADPOOL_WORKER_TIMEOUT 5000
+#define THREADPOOL_MAX_QUEUES 16
 #define MAXIMUM_WAITQUEUE_OBJECTS (MAXIMUM_WAIT_OBJECTS - 1)
 
+/* work item queue of a threadpool */
+struct threadpool_queue
+{
+    CRITICAL_SECTION        cs;
+    /* Pools of work items, locked via .cs, order matches TP_CALLBACK_PRIORITY - high, normal, low. */
+    struct list             pools[3];
+};
+
 /* internal threadpool representation */
 struct threadpool
 {
@@ -105,14 +114,21 @@ struct threadpool
     LONG                    objcount;
     BOOL                    shutdown;
     CRITICAL_SECTION        cs;
-    /* Pools of work items, locked via .cs, order matches TP_CALLBACK_PRIORITY - high, normal, low. */
-    struct list             pools[3];
+    /* Objects are assigned to one of the queues when they are created, and worker threads
+     * take work items from their own queue first, then from the other ones. */
+    struct threadpool_queue queues[THREADPOOL_MAX_QUEUES];
+    unsigned int            num_queues;
+    LONG                    next_queue;
+    /* number of queued objects for each priority, in all the queues */
+    LONG                    num_queued[3];
     RTL_CONDITION_VARIABLE  update_event;
     /* information about worker threads, locked via .cs */
     int                     max_workers;
     int                     min_workers;
     int                     num_workers;
-    int                     num_busy_workers;
+    /* number of busy and waiting worker threads, modified with interlocked functions */
+    LONG                    num_busy_workers;
+    LONG                    num_waiting_workers;
     HANDLE                  compl_port;
     TP_POOL_STACK_INFORMATION stack_info;
 };
@@ -141,6 +157,7 @@ struct threadpool_object
     /* read-only information */
     enum threadpool_objtype type;
     struct threadpool       *pool;
+    struct threadpool_queue *queue;
     struct threadpool_group *group;
     PVOID                   userdata;
     PTP_CLEANUP_GROUP_CANCEL_CALLBACK group_cancel_callback;
@@ -151,7 +168,7 @@ struct threadpool_object
     /* information about the group, locked via .group->cs */
     struct list             group_entry;
     BOOL                    is_group_member;
-    /* information about the pool, locked via .pool->cs */
+    /* information about the pool, locked via .queue->cs */
     struct list             pool_entry;
     RTL_CONDITION_VARIABLE  finished_event;
     RTL_CONDITION_VARIABLE  group_finished_event;
@@ -200,7 +217,7 @@ struct threadpool_object
         struct
         {
             PTP_IO_CALLBACK callback;
-            /* locked via .pool->cs */
+            /* locked via .queue->cs */
             unsigned int    pending_count, skipped_count, completion_count, completion_max;
             BOOL            shutting_down;
             struct io_completion *completions;
@@ -1362,9 +1379,9 @@ static void CALLBACK waitqueue_thread_proc( void *param )
                 {
                     InterlockedIncrement( &wait->refcount );
                     wait->num_pending_callbacks++;
-                    RtlEnterCriticalSection( &wait->pool->cs );
+                    RtlEnterCriticalSection( &wait->queue->cs );
                     tp_object_execute( wait, TRUE );
-                    RtlLeaveCriticalSection( &wait->pool->cs );
+                    RtlLeaveCriticalSection( &wait->queue->cs );
                     tp_object_release( wait );
                 }
                 else tp_object_submit( wait, FALSE );
@@ -1424,9 +1441,9 @@ static void CALLBACK waitqueue_thread_proc( void *param )
                     {
                         wait->u.wait.signaled++;
                         wait->num_pending_callbacks++;
-                        RtlEnterCriticalSection( &wait->pool->cs );
+                        RtlEnterCriticalSection( &wait->queue->cs );
                         tp_object_execute( wait, TRUE );
-                        RtlLeaveCriticalSection( &wait->pool->cs );
+                        RtlLeaveCriticalSection( &wait->queue->cs );
                     }
                     else tp_object_submit( wait, TRUE );
                 }
@@ -1634,7 +1651,7 @@ static void CALLBACK ioqueue_thread_proc( void *param )
 
         if (io && (io->shutdown || io->u.io.shutting_down))
         {
-            RtlEnterCriticalSection( &io->pool->cs );
+            RtlEnterCriticalSection( &io->queue->cs );
             if (!io->u.io.pending_count)
             {
                 if (io->u.io.skipped_count)
@@ -1645,7 +1662,7 @@ static void CALLBACK ioqueue_thread_proc( void *param )
                 else
                     destroy = TRUE;
             }
-            RtlLeaveCriticalSection( &io->pool->cs );
+            RtlLeaveCriticalSection( &io->queue->cs );
             if (skip) continue;
         }
 
@@ -1658,7 +1675,7 @@ static void CALLBACK ioqueue_thread_proc( void *param )
         }
         else if (io)
         {
-            RtlEnterCriticalSection( &io->pool->cs );
+            RtlEnterCriticalSection( &io->queue->cs );
 
             TRACE( "pending_count %u.\n", io->u.io.pending_count );
 
@@ -1669,7 +1686,7 @@ static void CALLBACK ioqueue_thread_proc( void *param )
                         io->u.io.completion_count + 1, sizeof(*io->u.io.completions)))
                 {
                     ERR( "Failed to allocate memory.\n" );
-                    RtlLeaveCriticalSection( &io->pool->cs );
+                    RtlLeaveCriticalSection( &io->queue->cs );
                     continue;
                 }
 
@@ -1679,7 +1696,7 @@ static void CALLBACK ioqueue_thread_proc( void *param )
 
                 tp_object_submit( io, FALSE );
             }
-            RtlLeaveCriticalSection( &io->pool->cs );
+            RtlLeaveCriticalSection( &io->queue->cs );
         }
 
         if (!ioqueue.objcount)
@@ -1759,7 +1776,7 @@ static NTSTATUS tp_threadpool_alloc( struct threadpool **out )
 {
     IMAGE_NT_HEADERS *nt = RtlImageNtHeader( NtCurrentTeb()->Peb->ImageBaseAddress );
     struct threadpool *pool;
-    unsigned int i;
+    unsigned int i, j;
 
     pool = RtlAllocateHeap( GetProcessHeap(), 0, sizeof(*pool) );
     if (!pool)
@@ -1772,14 +1789,26 @@ static NTSTATUS tp_threadpool_alloc( struct threadpool **out )
     RtlInitializeCriticalSectionEx( &pool->cs, 0, RTL_CRITICAL_SECTION_FLAG_FORCE_DEBUG_INFO );
     pool->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": threadpool.cs");
 
-    for (i = 0; i < ARRAY_SIZE(pool->pools); ++i)
-        list_init( &pool->pools[i] );
+    pool->num_queues = min( max( NtCurrentTeb()->Peb->NumberOfProcessors, 1 ), THREADPOOL_MAX_QUEUES );
+    for (i = 0; i < pool->num_queues; ++i)
+    {
+        struct threadpool_queue *queue = &pool->queues[i];
+
+        RtlInitializeCriticalSectionEx( &queue->cs, 0, RTL_CRITICAL_SECTION_FLAG_FORCE_DEBUG_INFO );
+        queue->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": threadpool_queue.cs");
+        for (j = 0; j < ARRAY_SIZE(queue->pools); ++j)
+            list_init( &queue->pools[j] );
+    }
+    pool->next_queue = 0;
+    for (i = 0; i < ARRAY_SIZE(pool->num_queued); ++i)
+        pool->num_queued[i] = 0;
     RtlInitializeConditionVariable( &pool->update_event );
 
     pool->max_workers             = 500;
     pool->min_workers             = 0;
     pool->num_workers             = 0;
     pool->num_busy_workers        = 0;
+    pool->num_waiting_workers     = 0;
     pool->stack_info.StackReserve = nt->OptionalHeader.SizeOfStackReserve;
     pool->stack_info.StackCommit  = nt->OptionalHeader.SizeOfStackCommit;
 
@@ -1811,7 +1840,7 @@ static void tp_threadpool_shutdown( struct threadpool *pool )
  */
 static BOOL tp_threadpool_release( struct threadpool *pool )
 {
-    unsigned int i;
+    unsigned int i, j;
 
     if (InterlockedDecrement( &pool->refcount ))
         return FALSE;
@@ -1820,8 +1849,15 @@ static BOOL tp_threadpool_release( struct threadpool *pool )
 
     assert( pool->shutdown );
     assert( !pool->objcount );
-    for (i = 0; i < ARRAY_SIZE(pool->pools); ++i)
-        assert( list_empty( &pool->pools[i] ) );
+    for (i = 0; i < pool->num_queues; ++i)
+    {
+        struct threadpool_queue *queue = &pool->queues[i];
+
+        for (j = 0; j < ARRAY_SIZE(queue->pools); ++j)
+            assert( list_empty( &queue->pools[j] ) );
+        queue->cs.DebugInfo->Spare[0] = 0;
+        RtlDeleteCriticalSection( &queue->cs );
+    }
 
     pool->cs.DebugInfo->Spare[0] = 0;
     RtlDeleteCriticalSection( &pool->cs );
@@ -1990,6 +2026,7 @@ static void tp_object_initialize( struct threadpool_object *object, struct threa
     object->shutdown                = FALSE;
 
     object->pool                    = pool;
+    object->queue                   = &pool->queues[(ULONG)InterlockedIncrement( &pool->next_queue ) % pool->num_queues];
     object->group                   = NULL;
     object->userdata                = userdata;
     object->group_cancel_callback   = NULL;
@@ -2025,7 +2062,7 @@ static void tp_object_initialize( struct threadpool_object *object, struct threa
             TP_CALLBACK_ENVIRON_V3 *environment_v3 = (TP_CALLBACK_ENVIRON_V3 *)environment;
 
             object->priority = environment_v3->CallbackPriority;
-            assert( object->priority < ARRAY_SIZE(pool->pools) );
+            assert( object->priority < ARRAY_SIZE(pool->num_queued) );
         }
 
         if (environment->ActivationContext)
@@ -2064,8 +2101,9 @@ static void tp_object_initialize( struct threadpool_object *object, struct threa
 
 static void tp_object_prio_queue( struct threadpool_object *object )
 {
-    ++object->pool->num_busy_workers;
-    list_add_tail( &object->pool->pools[object->priority], &object->pool_entry );
+    InterlockedIncrement( &object->pool->num_busy_workers );
+    InterlockedIncrement( &object->pool->num_queued[object->priority] );
+    list_add_tail( &object->queue->pools[object->priority], &object->pool_entry );
 }
 
 /***********************************************************************
@@ -2078,16 +2116,14 @@ static void tp_object_submit( struct threadpool_object *object, BOOL signaled )
 {
     struct threadpool *pool = object->pool;
     NTSTATUS status = STATUS_UNSUCCESSFUL;
+    BOOL new_worker;
 
     assert( !object->shutdown );
     assert( !pool->shutdown );
 
-    RtlEnterCriticalSection( &pool->cs );
+    new_worker = pool->num_busy_workers >= pool->num_workers && pool->num_workers < pool->max_workers;
 
-    /* Start new worker threads if required. */
-    if (pool->num_busy_workers >= pool->num_workers &&
-        pool->num_workers < pool->max_workers)
-        status = tp_new_worker_thread( pool );
+    RtlEnterCriticalSection( &object->queue->cs );
 
     /* Queue work item and increment refcount. */
     InterlockedIncrement( &object->refcount );
@@ -2098,6 +2134,18 @@ static void tp_object_submit( struct threadpool_object *object, BOOL signaled )
     if (object->type == TP_OBJECT_TYPE_WAIT && signaled)
         object->u.wait.signaled++;
 
+    RtlLeaveCriticalSection( &object->queue->cs );
+
+    /* The pool lock is only needed to start a new worker thread, or to wake up a waiting one.
+     * Waiting threads check the queued items after incrementing num_waiting_workers. */
+    if (!new_worker && !ReadNoFence( &pool->num_waiting_workers )) return;
+
+    RtlEnterCriticalSection( &pool->cs );
+
+    /* Start new worker threads if required. */
+    if (new_worker && pool->num_workers < pool->max_workers)
+        status = tp_new_worker_thread( pool );
+
     /* No new thread started - wake up one existing thread. */
     if (status != STATUS_SUCCESS)
     {
@@ -2115,15 +2163,16 @@ static void tp_object_submit( struct threadpool_object *object, BOOL signaled )
  */
 static void tp_object_cancel( struct threadpool_object *object )
 {
-    struct threadpool *pool = object->pool;
+    struct threadpool_queue *queue = object->queue;
     LONG pending_callbacks = 0;
 
-    RtlEnterCriticalSection( &pool->cs );
+    RtlEnterCriticalSection( &queue->cs );
     if (object->num_pending_callbacks)
     {
         pending_callbacks = object->num_pending_callbacks;
         object->num_pending_callbacks = 0;
         list_remove( &object->pool_entry );
+        InterlockedDecrement( &object->pool->num_queued[object->priority] );
 
         if (object->type == TP_OBJECT_TYPE_WAIT)
             object->u.wait.signaled = 0;
@@ -2133,7 +2182,7 @@ static void tp_object_cancel( struct threadpool_object *object )
         object->u.io.skipped_count += object->u.io.pending_count;
         object->u.io.pending_count = 0;
     }
-    RtlLeaveCriticalSection( &pool->cs );
+    RtlLeaveCriticalSection( &queue->cs );
 
     while (pending_callbacks--)
         tp_object_release( object );
@@ -2160,17 +2209,17 @@ static BOOL object_is_finished( struct threadpool_object *object, BOOL group )
  */
 static void tp_object_wait( struct threadpool_object *object, BOOL group_wait )
 {
-    struct threadpool *pool = object->pool;
+    struct threadpool_queue *queue = object->queue;
 
-    RtlEnterCriticalSection( &pool->cs );
+    RtlEnterCriticalSection( &queue->cs );
     while (!RtlDllShutdownInProgress() && !object_is_finished( object, group_wait ))
     {
         if (group_wait)
-            RtlSleepConditionVariableCS( &object->group_finished_event, &pool->cs, NULL );
+            RtlSleepConditionVariableCS( &object->group_finished_event, &queue->cs, NULL );
         else
-            RtlSleepConditionVariableCS( &object->finished_event, &pool->cs, NULL );
+            RtlSleepConditionVariableCS( &object->finished_event, &queue->cs, NULL );
     }
-    RtlLeaveCriticalSection( &pool->cs );
+    RtlLeaveCriticalSection( &queue->cs );
 }
 
 static void tp_ioqueue_unlock( struct threadpool_object *io )
@@ -2259,24 +2308,62 @@ static BOOL tp_object_release( struct threadpool_object *object )
     return TRUE;
 }
 
-static struct list *threadpool_get_next_item( const struct threadpool *pool )
+static BOOL threadpool_has_queued_items( struct threadpool *pool )
 {
-    struct list *ptr;
     unsigned int i;
 
-    for (i = 0; i < ARRAY_SIZE(pool->pools); ++i)
+    for (i = 0; i < ARRAY_SIZE(pool->num_queued); ++i)
+        if (ReadNoFence( &pool->num_queued[i] )) return TRUE;
+    return FALSE;
+}
+
+/***********************************************************************
+ *           threadpool_get_next_item    (internal)
+ *
+ * Returns the next object to execute, with the lock of its queue held.
+ * Items of the highest priority are taken first, from the specified queue
+ * if possible, otherwise from the other queues.
+ */
+static struct threadpool_object *threadpool_get_next_item( struct threadpool *pool, unsigned int home )
+{
+    struct threadpool_object *object;
+    struct threadpool_queue *queue;
+    struct list *ptr;
+    unsigned int i, prio;
+
+    for (prio = 0; prio < ARRAY_SIZE(pool->num_queued); ++prio)
     {
-        if ((ptr = list_head( &pool->pools[i] )))
-            break;
-    }
+        if (!ReadNoFence( &pool->num_queued[prio] )) continue;
+
+        for (i = 0; i < pool->num_queues; ++i)
+        {
+            queue = &pool->queues[(home + i) % pool->num_queues];
+            if (list_empty( &queue->pools[prio] )) continue;
 
-    return ptr;
+            RtlEnterCriticalSection( &queue->cs );
+            if ((ptr = list_head( &queue->pools[prio] )))
+            {
+                object = LIST_ENTRY( ptr, struct threadpool_object, pool_entry );
+                assert( object->num_pending_callbacks > 0 );
+
+                /* If further pending callbacks are queued, move the work item to
+                 * the end of the pool list. Otherwise remove it from the pool. */
+                list_remove( &object->pool_entry );
+                InterlockedDecrement( &pool->num_queued[prio] );
+                if (object->num_pending_callbacks > 1)
+                    tp_object_prio_queue( object );
+                return object;
+            }
+            RtlLeaveCriticalSection( &queue->cs );
+        }
+    }
+    return NULL;
 }
 
 /***********************************************************************
  *           tp_object_execute    (internal)
  *
- * Executes a threadpool object callback, object->pool->cs has to be
+ * Executes a threadpool object callback, object->queue->cs has to be
  * held.
  */
 static void tp_object_execute( struct threadpool_object *object, BOOL wait_thread )
@@ -2284,7 +2371,7 @@ static void tp_object_execute( struct threadpool_object *object, BOOL wait_threa
     TP_CALLBACK_INSTANCE *callback_instance;
     struct threadpool_instance instance;
     struct io_completion completion;
-    struct threadpool *pool = object->pool;
+    struct threadpool_queue *queue = object->queue;
     TP_WAIT_RESULT wait_result = 0;
     NTSTATUS status;
 
@@ -2305,7 +2392,7 @@ static void tp_object_execute( struct threadpool_object *object, BOOL wait_threa
     /* Leave critical section and do the actual callback. */
     object->num_associated_callbacks++;
     object->num_running_callbacks++;
-    RtlLeaveCriticalSection( &pool->cs );
+    RtlLeaveCriticalSection( &queue->cs );
     if (wait_thread) RtlLeaveCriticalSection( &waitqueue.cs );
 
     /* Initialize threadpool instance struct. */
@@ -2411,7 +2498,7 @@ static void tp_object_execute( struct threadpool_object *object, BOOL wait_threa
 
 skip_cleanup:
     if (wait_thread) RtlEnterCriticalSection( &waitqueue.cs );
-    RtlEnterCriticalSection( &pool->cs );
+    RtlEnterCriticalSection( &queue->cs );
 
     /* Simple callbacks are automatically shutdown after execution. */
     if (object->type == TP_OBJECT_TYPE_SIMPLE)
@@ -2438,33 +2525,33 @@ skip_cleanup:
 static void CALLBACK threadpool_worker_proc( void *param )
 {
     struct threadpool *pool = param;
+    struct threadpool_object *object;
     LARGE_INTEGER timeout;
-    struct list *ptr;
+    unsigned int home;
+    NTSTATUS status;
 
     TRACE( "starting worker thread for pool %p\n", pool );
     set_thread_name(L"wine_threadpool_worker");
 
+    home = (ULONG)InterlockedIncrement( &pool->next_queue ) % pool->num_queues;
+
     RtlEnterCriticalSection( &pool->cs );
     for (;;)
     {
-        while ((ptr = threadpool_get_next_item( pool )))
+        RtlLeaveCriticalSection( &pool->cs );
+        while ((object = threadpool_get_next_item( pool, home )))
         {
-            struct threadpool_object *object = LIST_ENTRY( ptr, struct threadpool_object, pool_entry );
-            assert( object->num_pending_callbacks > 0 );
-
-            /* If further pending callbacks are queued, move the work item to
-             * the end of the pool list. Otherwise remove it from the pool. */
-            list_remove( &object->pool_entry );
-            if (object->num_pending_callbacks > 1)
-                tp_object_prio_queue( object );
+            struct threadpool_queue *queue = object->queue;
 
             tp_object_execute( object, FALSE );
+            RtlLeaveCriticalSection( &queue->cs );
 
             assert(pool->num_busy_workers);
-            pool->num_busy_workers--;
+            InterlockedDecrement( &pool->num_busy_workers );
 
             tp_object_release( object );
         }
+        RtlEnterCriticalSection( &pool->cs );
 
         /* Shutdown worker thread if requested. */
         if (pool->shutdown)
@@ -2476,8 +2563,12 @@ static void CALLBACK threadpool_worker_proc( void *param )
          * min_workers == 0, then objcount is used to detect if the last thread
          * can be terminated. */
         timeout.QuadPart = (ULONGLONG)THREADPOOL_WORKER_TIMEOUT * -10000;
-        if (RtlSleepConditionVariableCS( &pool->update_event, &pool->cs, &timeout ) == STATUS_TIMEOUT &&
-            !threadpool_get_next_item( pool ) && (pool->num_workers > max( pool->min_workers, 1 ) ||
+        InterlockedIncrement( &pool->num_waiting_workers );
+        if (threadpool_has_queued_items( pool )) status = STATUS_SUCCESS;
+        else status = RtlSleepConditionVariableCS( &pool->update_event, &pool->cs, &timeout );
+        InterlockedDecrement( &pool->num_waiting_workers );
+        if (status == STATUS_TIMEOUT &&
+            !threadpool_has_queued_items( pool ) && (pool->num_workers > max( pool->min_workers, 1 ) ||
             (!pool->min_workers && !pool->objcount)))
         {
             break;
@@ -2684,7 +2775,7 @@ void WINAPI TpCancelAsyncIoOperation( TP_IO *io )
 
     TRACE( "%p\n", io );
 
-    RtlEnterCriticalSection( &this->pool->cs );
+    RtlEnterCriticalSection( &this->queue->cs );
 
     TRACE("pending_count %u.\n", this->u.io.pending_count);
 
@@ -2694,7 +2785,7 @@ void WINAPI TpCancelAsyncIoOperation( TP_IO *io )
     if (object_is_finished( this, FALSE ))
         RtlWakeAllConditionVariable( &this->finished_event );
 
-    RtlLeaveCriticalSection( &this->pool->cs );
+    RtlLeaveCriticalSection( &this->queue->cs );
 }
 
 /***********************************************************************
@@ -2814,7 +2905,7 @@ VOID WINAPI TpDisassociateCallback( TP_CALLBACK_INSTANCE *instance )
 {
     struct threadpool_instance *this = impl_from_TP_CALLBACK_INSTANCE( instance );
     struct threadpool_object *object = this->object;
-    struct threadpool *pool;
+    struct threadpool_queue *queue;
 
     TRACE( "%p\n", instance );
 
@@ -2827,14 +2918,14 @@ VOID WINAPI TpDisassociateCallback( TP_CALLBACK_INSTANCE *instance )
     if (!this->associated)
         return;
 
-    pool = object->pool;
-    RtlEnterCriticalSection( &pool->cs );
+    queue = object->queue;
+    RtlEnterCriticalSection( &queue->cs );
 
     object->num_associated_callbacks--;
     if (object_is_finished( object, FALSE ))
         RtlWakeAllConditionVariable( &object->finished_event );
 
-    RtlLeaveCriticalSection( &pool->cs );
+    RtlLeaveCriticalSection( &queue->cs );
     this->associated = FALSE;
 }
 
@@ -2958,10 +3049,10 @@ void WINAPI TpReleaseIoCompletion( TP_IO *io )
 
     TRACE( "%p\n", io );
 
-    RtlEnterCriticalSection( &this->pool->cs );
+    RtlEnterCriticalSection( &this->queue->cs );
     this->u.io.shutting_down = TRUE;
     can_destroy = !this->u.io.pending_count && !this->u.io.skipped_count;
-    RtlLeaveCriticalSection( &this->pool->cs );
+    RtlLeaveCriticalSection( &this->queue->cs );
 
     if (can_destroy)
     {
@@ -3261,11 +3352,11 @@ void WINAPI TpStartAsyncIoOperation( TP_IO *io )
 
     TRACE( "%p\n", io );
 
-    RtlEnterCriticalSection( &this->pool->cs );
+    RtlEnterCriticalSection( &this->queue->cs );
 
     this->u.io.pending_count++;
 
-    RtlLeaveCriticalSection( &this->pool->cs );
+    RtlLeaveCriticalSection( &this->queue->cs );
 }
 
 /***********************************************************************
@@ -3457,11 +3548,11 @@ NTSTATUS WINAPI RtlDeregisterWaitEx( HANDLE handle, HANDLE event )
         object->completed_event = event;
     }
 
-    RtlEnterCriticalSection( &object->pool->cs );
+    RtlEnterCriticalSection( &object->queue->cs );
     if (object->num_pending_callbacks + object->num_running_callbacks
         + object->num_associated_callbacks) status = STATUS_PENDING;
     else status = STATUS_SUCCESS;
-    RtlLeaveCriticalSection( &object->pool->cs );
+    RtlLeaveCriticalSection( &object->queue->cs );
 
     TpReleaseWait( (TP_WAIT *)object );
     return status;
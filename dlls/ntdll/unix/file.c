@@ -51,6 +51,7 @@
 #endif
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <sys/uio.h>
 #include <sys/ioctl.h>
 #ifdef HAVE_SYS_ATTR_H
 #include <sys/attr.h>
@@ -1772,7 +1773,9 @@ static NTSTATUS fd_set_file_info( int fd, UINT attr, BOOL force_set_xattr )
 
 
 /* get the stat info and file attributes for a file (by name) */
-static int get_file_info( const char *path, struct stat *st, ULONG *attr, ULONG *reparse_tag )
+/* if parent is specified, it is the identity of the directory containing path */
+static int get_file_info( const char *path, const struct file_identity *parent,
+                          struct stat *st, ULONG *attr, ULONG *reparse_tag )
 {
     char buffer[MAXIMUM_REPARSE_DATA_BUFFER_SIZE];
     size_t len = strlen( path );
@@ -1795,6 +1798,15 @@ static int get_file_info( const char *path, struct stat *st, ULONG *attr, ULONG
             if (reparse_tag) *reparse_tag = IO_REPARSE_TAG_LX_SYMLINK;
         }
     }
+    else if (S_ISDIR( st->st_mode ) && parent)
+    {
+        /* consider mount points to be reparse points (IO_REPARSE_TAG_MOUNT_POINT) */
+        if (st->st_dev != parent->dev || st->st_ino == parent->ino)
+        {
+            *attr |= FILE_ATTRIBUTE_REPARSE_POINT;
+            if (reparse_tag) *reparse_tag = IO_REPARSE_TAG_MOUNT_POINT;
+        }
+    }
     else if (S_ISDIR( st->st_mode ) && (parent_path = malloc( len + 4 )))
     {
         struct stat parent_st;
@@ -2465,10 +2477,24 @@ static NTSTATUS get_dir_data_entry( struct dir_data *dir_data, void *info_ptr, I
 {
     const struct dir_data_names *names = &dir_data->names[dir_data->pos];
     union file_directory_info *info;
+    const struct file_identity *parent = NULL;
     struct stat st;
     ULONG name_len, start, dir_size, attributes, reparse_tag;
+    int ret;
 
-    if (get_file_info( names->unix_name, &st, &attributes, &reparse_tag ) == -1)
+    if (class == FileNamesInformation)
+    {
+        /* only the name is returned, don't bother with attributes and reparse data */
+        attributes = reparse_tag = 0;
+        ret = stat( names->unix_name, &st );
+    }
+    else
+    {
+        /* the parent of a plain subdirectory is the directory being listed */
+        if (strcmp( names->unix_name, "." ) && strcmp( names->unix_name, ".." )) parent = &dir_data->id;
+        ret = get_file_info( names->unix_name, parent, &st, &attributes, &reparse_tag );
+    }
+    if (ret == -1)
     {
         TRACE( "file no longer exists %s\n", debugstr_a(names->unix_name) );
         return STATUS_SUCCESS;
@@ -2988,6 +3014,303 @@ NTSTATUS WINAPI NtQueryDirectoryFile( HANDLE handle, HANDLE event, PIO_APC_ROUTI
 }
 
 
+/* cache of directory contents for case-insensitive lookups */
+
+struct dir_lookup_key
+{
+    unsigned int   hash;       /* hash of the upper-case name */
+    unsigned int   next;       /* next key in the hash bucket */
+    unsigned int   index;      /* index of the entry in readdir order */
+    unsigned int   unix_name;  /* offset of the Unix name in the unix_names pool */
+    unsigned int   name;       /* offset of the name in the names pool */
+    unsigned short len;        /* length of the name in chars */
+    BOOLEAN        is_short;   /* whether this is the hashed short name of a long file name */
+};
+
+struct dir_lookup_cache
+{
+    struct list            entry;        /* entry in the LRU list */
+    struct stat            st;           /* stat of the directory when it was read */
+    unsigned int           count;        /* number of keys */
+    unsigned int           buckets_mask; /* number of hash buckets - 1 */
+    unsigned int          *buckets;      /* hash buckets, indexes in the keys array */
+    struct dir_lookup_key *keys;         /* lookup keys for the directory entries */
+    char                  *unix_names;   /* pool of Unix names */
+    WCHAR                 *names;        /* pool of WCHAR names */
+    size_t                 size;         /* total allocated size */
+};
+
+#define DIR_LOOKUP_CACHE_MAX_DIRS  64                 /* max number of cached directories */
+#define DIR_LOOKUP_CACHE_MAX_SIZE  (16 * 1024 * 1024) /* max total size of the cached data */
+#define DIR_LOOKUP_CACHE_MIN_AGE   2                  /* min age in seconds of a directory to cache it */
+
+static struct list dir_lookup_caches = LIST_INIT( dir_lookup_caches );
+static unsigned int dir_lookup_cache_count;
+static size_t dir_lookup_cache_size;
+static pthread_mutex_t dir_lookup_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static unsigned int hash_dir_entry_name( const WCHAR *name, int length )
+{
+    unsigned int i, hash = 0;
+    for (i = 0; i < length; i++) hash = hash * 0x1f + towupper( name[i] );
+    return hash;
+}
+
+/* check that two directory stats are identical, i.e. no entries have been added, removed or renamed */
+static BOOL dir_stat_equal( const struct stat *st1, const struct stat *st2 )
+{
+    if (st1->st_dev != st2->st_dev || st1->st_ino != st2->st_ino) return FALSE;
+    if (st1->st_size != st2->st_size || st1->st_nlink != st2->st_nlink) return FALSE;
+    if (st1->st_mtime != st2->st_mtime || st1->st_ctime != st2->st_ctime) return FALSE;
+#ifdef HAVE_STRUCT_STAT_ST_MTIM
+    if (st1->st_mtim.tv_nsec != st2->st_mtim.tv_nsec) return FALSE;
+#elif defined(HAVE_STRUCT_STAT_ST_MTIMESPEC)
+    if (st1->st_mtimespec.tv_nsec != st2->st_mtimespec.tv_nsec) return FALSE;
+#endif
+#ifdef HAVE_STRUCT_STAT_ST_CTIM
+    if (st1->st_ctim.tv_nsec != st2->st_ctim.tv_nsec) return FALSE;
+#elif defined(HAVE_STRUCT_STAT_ST_CTIMESPEC)
+    if (st1->st_ctimespec.tv_nsec != st2->st_ctimespec.tv_nsec) return FALSE;
+#endif
+    return TRUE;
+}
+
+/* the directory times are our only way to notice changes, so don't cache directories that have
+ * been modified too recently, as a later change may not be visible with a coarse time granularity */
+static BOOL is_dir_lookup_cacheable( const struct stat *st )
+{
+    time_t now = time( NULL );
+    return now - st->st_mtime > DIR_LOOKUP_CACHE_MIN_AGE && now - st->st_ctime > DIR_LOOKUP_CACHE_MIN_AGE;
+}
+
+static void free_dir_lookup_cache( struct dir_lookup_cache *cache )
+{
+    free( cache->buckets );
+    free( cache->keys );
+    free( cache->unix_names );
+    free( cache->names );
+    free( cache );
+}
+
+static BOOL grow_dir_lookup_pool( void **pool, size_t *size, size_t needed, size_t elem_size )
+{
+    size_t new_size = *size;
+    void *ptr;
+
+    if (needed <= *size) return TRUE;
+    while (new_size < needed) new_size = max( new_size * 2, 4096 );
+    if (!(ptr = realloc( *pool, new_size * elem_size ))) return FALSE;
+    *pool = ptr;
+    *size = new_size;
+    return TRUE;
+}
+
+static BOOL add_dir_lookup_key( struct dir_lookup_cache *cache, size_t *keys_size, size_t *names_size,
+                                unsigned int index, unsigned int unix_name, const WCHAR *name, int length,
+                                BOOLEAN is_short )
+{
+    struct dir_lookup_key *key;
+    unsigned int offset = cache->count ? cache->keys[cache->count - 1].name + cache->keys[cache->count - 1].len : 0;
+
+    if (!grow_dir_lookup_pool( (void **)&cache->keys, keys_size, cache->count + 1, sizeof(*cache->keys) ))
+        return FALSE;
+    if (!grow_dir_lookup_pool( (void **)&cache->names, names_size, offset + length, sizeof(WCHAR) ))
+        return FALSE;
+
+    memcpy( cache->names + offset, name, length * sizeof(WCHAR) );
+    key = &cache->keys[cache->count++];
+    key->hash      = hash_dir_entry_name( name, length );
+    key->index     = index;
+    key->unix_name = unix_name;
+    key->name      = offset;
+    key->len       = length;
+    key->is_short  = is_short;
+    return TRUE;
+}
+
+/***********************************************************************
+ *           create_dir_lookup_cache
+ *
+ * Read the contents of a directory into a new lookup cache.
+ */
+static struct dir_lookup_cache *create_dir_lookup_cache( DIR *dir, const struct stat *st )
+{
+    WCHAR buffer[MAX_DIR_ENTRY_LEN], short_nameW[12];
+    size_t keys_size = 0, names_size = 0, unix_names_size = 0, unix_names_pos = 0, len;
+    struct dir_lookup_cache *cache;
+    unsigned int i, index;
+    struct dirent *de;
+    int ret;
+
+    if (!(cache = calloc( 1, sizeof(*cache) ))) return NULL;
+    cache->st = *st;
+
+    for (index = 0; (de = readdir( dir )); index++)
+    {
+        len = strlen( de->d_name ) + 1;
+        if (!grow_dir_lookup_pool( (void **)&cache->unix_names, &unix_names_size, unix_names_pos + len, 1 ))
+            goto failed;
+        memcpy( cache->unix_names + unix_names_pos, de->d_name, len );
+
+        ret = ntdll_umbstowcs( de->d_name, len - 1, buffer, MAX_DIR_ENTRY_LEN );
+        if (!add_dir_lookup_key( cache, &keys_size, &names_size, index, unix_names_pos, buffer, ret, FALSE ))
+            goto failed;
+        if (!is_legal_8dot3_name( buffer, ret ))
+        {
+            ret = hash_short_file_name( buffer, ret, short_nameW );
+            if (!add_dir_lookup_key( cache, &keys_size, &names_size, index, unix_names_pos, short_nameW, ret, TRUE ))
+                goto failed;
+        }
+        unix_names_pos += len;
+    }
+
+    for (i = 1; i < cache->count; i <<= 1) ;
+    cache->buckets_mask = i - 1;
+    if (!(cache->buckets = malloc( i * sizeof(*cache->buckets) ))) goto failed;
+    memset( cache->buckets, 0xff, i * sizeof(*cache->buckets) );
+    for (i = 0; i < cache->count; i++)
+    {
+        struct dir_lookup_key *key = &cache->keys[i];
+        key->next = cache->buckets[key->hash & cache->buckets_mask];
+        cache->buckets[key->hash & cache->buckets_mask] = i;
+    }
+
+    cache->size = sizeof(*cache) + (cache->buckets_mask + 1) * sizeof(*cache->buckets) +
+                  keys_size * sizeof(*cache->keys) + names_size * sizeof(WCHAR) + unix_names_size;
+    return cache;
+
+failed:
+    free_dir_lookup_cache( cache );
+    return NULL;
+}
+
+/***********************************************************************
+ *           find_dir_lookup_cache_name
+ *
+ * Find a name in a directory lookup cache, returning the first matching entry in readdir
+ * order, as find_file_in_dir does. dir_lookup_mutex must be held.
+ */
+static const char *find_dir_lookup_cache_name( const struct dir_lookup_cache *cache, const WCHAR *name,
+                                               int length, BOOLEAN short_names )
+{
+    unsigned int i, hash = hash_dir_entry_name( name, length );
+    const struct dir_lookup_key *key, *found = NULL;
+
+    for (i = cache->buckets[hash & cache->buckets_mask]; i != ~0u; i = key->next)
+    {
+        key = &cache->keys[i];
+        if (key->hash != hash || key->len != length) continue;
+        if (key->is_short && !short_names) continue;
+        if (found && found->index <= key->index) continue;
+        if (!wcsnicmp( cache->names + key->name, name, length )) found = key;
+    }
+    return found ? cache->unix_names + found->unix_name : NULL;
+}
+
+/* remove a cache from the list and free it; dir_lookup_mutex must be held */
+static void remove_dir_lookup_cache( struct dir_lookup_cache *cache )
+{
+    list_remove( &cache->entry );
+    dir_lookup_cache_count--;
+    dir_lookup_cache_size -= cache->size;
+    free_dir_lookup_cache( cache );
+}
+
+/* find the cache for a directory, whether it's still valid or not; dir_lookup_mutex must be held */
+static struct dir_lookup_cache *find_dir_lookup_cache( const struct stat *st )
+{
+    struct dir_lookup_cache *cache;
+
+    LIST_FOR_EACH_ENTRY( cache, &dir_lookup_caches, struct dir_lookup_cache, entry )
+        if (cache->st.st_dev == st->st_dev && cache->st.st_ino == st->st_ino) return cache;
+    return NULL;
+}
+
+/* get the cache for a directory if it's still valid; dir_lookup_mutex must be held */
+static struct dir_lookup_cache *get_dir_lookup_cache( const struct stat *st )
+{
+    struct dir_lookup_cache *cache;
+
+    if (!(cache = find_dir_lookup_cache( st ))) return NULL;
+    if (!dir_stat_equal( &cache->st, st ))
+    {
+        remove_dir_lookup_cache( cache );
+        return NULL;
+    }
+    list_remove( &cache->entry );
+    list_add_head( &dir_lookup_caches, &cache->entry );
+    return cache;
+}
+
+/* add a cache to the list, evicting the least recently used ones; dir_lookup_mutex must be held */
+static void add_dir_lookup_cache( struct dir_lookup_cache *cache )
+{
+    struct dir_lookup_cache *old;
+    struct list *ptr;
+
+    if ((old = find_dir_lookup_cache( &cache->st ))) remove_dir_lookup_cache( old );
+    list_add_head( &dir_lookup_caches, &cache->entry );
+    dir_lookup_cache_count++;
+    dir_lookup_cache_size += cache->size;
+
+    while ((dir_lookup_cache_count > DIR_LOOKUP_CACHE_MAX_DIRS || dir_lookup_cache_size > DIR_LOOKUP_CACHE_MAX_SIZE) &&
+           (ptr = list_tail( &dir_lookup_caches )) != &cache->entry)
+        remove_dir_lookup_cache( LIST_ENTRY( ptr, struct dir_lookup_cache, entry ) );
+}
+
+/***********************************************************************
+ *           find_file_in_dir_cache
+ *
+ * Case-insensitive search of a file in a directory through the lookup cache,
+ * reading the directory into the cache if necessary. unix_name contains the
+ * directory name, and the file found is appended to it at pos.
+ * Returns STATUS_NOT_SUPPORTED if the cache cannot be used for this directory.
+ */
+static NTSTATUS find_file_in_dir_cache( int root_fd, char *unix_name, int pos, const WCHAR *name, int length,
+                                        BOOLEAN short_names )
+{
+    struct dir_lookup_cache *cache;
+    const char *found = NULL;
+    struct stat st;
+    DIR *dir;
+    int fd;
+
+    if (fstatat( root_fd, unix_name, &st, 0 ) == -1) return STATUS_NOT_SUPPORTED;
+
+    mutex_lock( &dir_lookup_mutex );
+    if ((cache = get_dir_lookup_cache( &st )) &&
+        (found = find_dir_lookup_cache_name( cache, name, length, short_names )))
+    {
+        unix_name[pos - 1] = '/';
+        strcpy( unix_name + pos, found );
+    }
+    mutex_unlock( &dir_lookup_mutex );
+    if (cache) return found ? STATUS_SUCCESS : STATUS_OBJECT_NAME_NOT_FOUND;
+
+    if (!is_dir_lookup_cacheable( &st )) return STATUS_NOT_SUPPORTED;
+    if ((fd = openat( root_fd, unix_name, O_RDONLY | O_DIRECTORY )) == -1) return STATUS_NOT_SUPPORTED;
+    /* get the directory times again before reading it, so that later changes are noticed */
+    if (fstat( fd, &st ) == -1 || !is_dir_lookup_cacheable( &st ) || !(dir = fdopendir( fd )))
+    {
+        close( fd );
+        return STATUS_NOT_SUPPORTED;
+    }
+    cache = create_dir_lookup_cache( dir, &st );
+    closedir( dir );
+    if (!cache) return STATUS_NOT_SUPPORTED;
+
+    mutex_lock( &dir_lookup_mutex );
+    if ((found = find_dir_lookup_cache_name( cache, name, length, short_names )))
+    {
+        unix_name[pos - 1] = '/';
+        strcpy( unix_name + pos, found );
+    }
+    add_dir_lookup_cache( cache );
+    mutex_unlock( &dir_lookup_mutex );
+    return found ? STATUS_SUCCESS : STATUS_OBJECT_NAME_NOT_FOUND;
+}
+
+
 /***********************************************************************
  *           find_file_in_dir
  *
@@ -3000,6 +3323,7 @@ static NTSTATUS find_file_in_dir( int root_fd, char *unix_name, int pos, const W
 {
     WCHAR buffer[MAX_DIR_ENTRY_LEN];
     BOOLEAN is_name_8_dot_3;
+    NTSTATUS status;
     DIR *dir;
     struct dirent *de;
     struct stat st;
@@ -3078,6 +3402,10 @@ static NTSTATUS find_file_in_dir( int root_fd, char *unix_name, int pos, const W
     }
 #endif /* VFAT_IOCTL_READDIR_BOTH */
 
+    status = find_file_in_dir_cache( root_fd, unix_name, pos, name, length, is_name_8_dot_3 );
+    if (status == STATUS_SUCCESS) return status;
+    if (status != STATUS_NOT_SUPPORTED) goto not_found;
+
     if ((fd = openat( root_fd, unix_name, O_RDONLY )) == -1) return errno_to_status( errno );
     if (!(dir = fdopendir( fd )))
     {
@@ -4891,7 +5219,7 @@ NTSTATUS WINAPI NtQueryFullAttributesFile( const OBJECT_ATTRIBUTES *attr,
         ULONG attributes;
         struct stat st;
 
-        if (get_file_info( unix_name, &st, &attributes, NULL ) == -1)
+        if (get_file_info( unix_name, NULL, &st, &attributes, NULL ) == -1)
             status = errno_to_status( errno );
         else if (!S_ISREG(st.st_mode) && !S_ISDIR(st.st_mode))
             status = STATUS_INVALID_INFO_CLASS;
@@ -4920,7 +5248,7 @@ NTSTATUS WINAPI NtQueryAttributesFile( const OBJECT_ATTRIBUTES *attr, FILE_BASIC
         ULONG attributes;
         struct stat st;
 
-        if (get_file_info( unix_name, &st, &attributes, NULL ) == -1)
+        if (get_file_info( unix_name, NULL, &st, &attributes, NULL ) == -1)
             status = errno_to_status( errno );
         else if (!S_ISREG(st.st_mode) && !S_ISDIR(st.st_mode))
             status = STATUS_INVALID_INFO_CLASS;
@@ -6245,6 +6573,26 @@ err:
 }
 
 
+#if defined(HAVE_PREADV) || defined(HAVE_PWRITEV)
+
+#define MAX_SEGMENT_IOVECS 64
+
+/* build an iovec array for page-sized segments, starting at offset pos in the first one */
+static int get_segments_iovec( struct iovec *iov, FILE_SEGMENT_ELEMENT *segments, UINT pos, ULONG length )
+{
+    int count;
+
+    for (count = 0; count < MAX_SEGMENT_IOVECS && length; count++, pos = 0)
+    {
+        iov[count].iov_base = (char *)segments[count].Buffer + pos;
+        iov[count].iov_len  = min( length, page_size - pos );
+        length -= iov[count].iov_len;
+    }
+    return count;
+}
+
+#endif
+
 /******************************************************************************
  *              NtReadFileScatter   (NTDLL.@)
  */
@@ -6278,11 +6626,21 @@ NTSTATUS WINAPI NtReadFileScatter( HANDLE file, HANDLE event, PIO_APC_ROUTINE ap
 
     while (length)
     {
+#ifdef HAVE_PREADV
+        struct iovec iov[MAX_SEGMENT_IOVECS];
+        int count = get_segments_iovec( iov, segments, pos, length );
+
+        if (offset && offset->QuadPart != FILE_USE_FILE_POINTER_POSITION)
+            result = preadv( unix_handle, iov, count, offset->QuadPart + total );
+        else
+            result = readv( unix_handle, iov, count );
+#else
         if (offset && offset->QuadPart != FILE_USE_FILE_POINTER_POSITION)
             result = pread( unix_handle, (char *)segments->Buffer + pos,
                             min( length - pos, page_size - pos ), offset->QuadPart + total );
         else
             result = read( unix_handle, (char *)segments->Buffer + pos, min( length - pos, page_size - pos ) );
+#endif
 
         if (result == -1)
         {
@@ -6293,11 +6651,9 @@ NTSTATUS WINAPI NtReadFileScatter( HANDLE file, HANDLE event, PIO_APC_ROUTINE ap
         if (!result) break;
         total += result;
         length -= result;
-        if ((pos += result) == page_size)
-        {
-            pos = 0;
-            segments++;
-        }
+        pos += result;
+        segments += pos / page_size;
+        pos %= page_size;
     }
 
     if (total == 0) status = STATUS_END_OF_FILE;
@@ -6578,11 +6934,21 @@ NTSTATUS WINAPI NtWriteFileGather( HANDLE file, HANDLE event, PIO_APC_ROUTINE ap
 
     while (length)
     {
+#ifdef HAVE_PWRITEV
+        struct iovec iov[MAX_SEGMENT_IOVECS];
+        int count = get_segments_iovec( iov, segments, pos, length );
+
+        if (offset && offset->QuadPart != FILE_USE_FILE_POINTER_POSITION)
+            result = pwritev( unix_handle, iov, count, offset->QuadPart + total );
+        else
+            result = writev( unix_handle, iov, count );
+#else
         if (offset && offset->QuadPart != FILE_USE_FILE_POINTER_POSITION)
             result = pwrite( unix_handle, (char *)segments->Buffer + pos,
                              page_size - pos, offset->QuadPart + total );
         else
             result = write( unix_handle, (char *)segments->Buffer + pos, page_size - pos );
+#endif
 
         if (result == -1)
         {
@@ -6602,11 +6968,9 @@ NTSTATUS WINAPI NtWriteFileGather( HANDLE file, HANDLE event, PIO_APC_ROUTINE ap
         }
         total += result;
         length -= result;
-        if ((pos += result) == page_size)
-        {
-            pos = 0;
-            segments++;
-        }
+        pos += result;
+        segments += pos / page_size;
+        pos %= page_size;
     }
 
  done:
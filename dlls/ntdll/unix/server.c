@@ -90,7 +90,7 @@ WINE_DECLARE_DEBUG_CHANNEL(syscall);
 #define SOCKETNAME "socket"        /* name of the socket file */
 #define LOCKNAME   "lock"          /* name of the lock file */
 
-static const char *server_dir;
+const char *server_dir;
 
 unsigned int supported_machines_count = 0;
 USHORT supported_machines[8] = { 0 };
@@ -272,9 +272,34 @@ static void read_reply_data( int reply_fd, void *buffer, size_t size )
  */
 static inline unsigned int wait_reply( int reply_fd, struct __server_request_info *req )
 {
-    read_reply_data( reply_fd, &req->u.reply, sizeof(req->u.reply) );
-    if (req->u.reply.reply_header.reply_size)
-        read_reply_data( reply_fd, req->reply_data, req->u.reply.reply_header.reply_size );
+    data_size_t max_size = req->u.req.request_header.reply_size;
+    struct iovec vec[2];
+    ssize_t ret;
+
+    /* the server sends the reply and its data in a single write, so try to get both at once */
+    vec[0].iov_base = &req->u.reply;
+    vec[0].iov_len  = sizeof(req->u.reply);
+    vec[1].iov_base = req->reply_data;
+    vec[1].iov_len  = max_size;
+
+    while ((ret = readv( reply_fd, vec, max_size ? 2 : 1 )) < 0)
+    {
+        if (errno == EINTR) continue;
+        if (errno == EPIPE) abort_thread(0);
+        server_protocol_perror("read");
+    }
+    /* the server closed the connection; time to die... */
+    if (!ret) abort_thread(0);
+
+    if (ret < sizeof(req->u.reply))
+    {
+        read_reply_data( reply_fd, (char *)&req->u.reply + ret, sizeof(req->u.reply) - ret );
+        ret = sizeof(req->u.reply);
+    }
+    ret -= sizeof(req->u.reply);
+    if (req->u.reply.reply_header.reply_size > ret)
+        read_reply_data( reply_fd, (char *)req->reply_data + ret,
+                         req->u.reply.reply_header.reply_size - ret );
     return req->u.reply.reply_header.error;
 }
 
@@ -29,6 +29,9 @@
 #include <sys/socket.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
+#ifdef HAVE_SYS_SENDFILE_H
+# include <sys/sendfile.h>
+#endif
 #ifdef HAVE_IFADDRS_H
 # include <ifaddrs.h>
 #endif
@@ -42,6 +45,9 @@
 #ifdef HAVE_NETINET_TCP_H
 # include <netinet/tcp.h>
 #endif
+#ifdef HAVE_NETINET_UDP_H
+# include <netinet/udp.h>
+#endif
 
 #ifdef HAVE_NETIPX_IPX_H
 # include <netipx/ipx.h>
@@ -146,6 +152,7 @@ struct async_transmit_ioctl
     unsigned int tail_cursor;   /* amount of tail data already sent */
     unsigned int file_len;      /* total file length to send */
     unsigned int flags;
+    BOOL no_sendfile;           /* sendfile() isn't supported for this file and socket */
     const char *head;
     const char *tail;
     unsigned int head_len;
@@ -497,6 +504,26 @@ static int convert_control_headers(struct msghdr *hdr, WSABUF *control)
                 }
                 break;
 
+            case IPPROTO_UDP:
+                switch (cmsg_unix->cmsg_type)
+                {
+#if defined(UDP_GRO)
+                    case UDP_GRO:
+                    {
+                        DWORD segment_size = *(int *)CMSG_DATA(cmsg_unix);
+                        ptr = fill_control_message( WS_IPPROTO_UDP, WS_UDP_COALESCED_INFO, ptr, &ctlsize,
+                                                    &segment_size, sizeof(segment_size) );
+                        if (!ptr) goto error;
+                        break;
+                    }
+#endif /* UDP_GRO */
+
+                    default:
+                        FIXME("Unhandled IPPROTO_UDP message header type %d\n", cmsg_unix->cmsg_type);
+                        break;
+                }
+                break;
+
             default:
                 FIXME("Unhandled message header level %d\n", cmsg_unix->cmsg_level);
                 break;
@@ -1386,6 +1413,36 @@ static NTSTATUS try_transmit( int sock_fd, int file_fd, struct async_transmit_io
         async->file_cursor += ret;
     }
 
+#ifdef HAVE_SYS_SENDFILE_H
+    /* let the kernel copy the file data directly to the socket */
+    while (async->file && !async->no_sendfile && async->buffer_cursor == async->read_len)
+    {
+        size_t count = async->file_len ? async->file_len - async->file_cursor : 0x7ffff000;
+        off_t offset = async->offset.QuadPart;
+
+        TRACE( "sending %zu bytes of file data with sendfile\n", count );
+        if (async->offset.QuadPart == FILE_USE_FILE_POINTER_POSITION)
+            ret = sendfile( sock_fd, file_fd, NULL, count );
+        else
+            ret = sendfile( sock_fd, file_fd, &offset, count );
+        if (ret < 0)
+        {
+            if (errno == EINTR) continue;
+            if (errno != EINVAL && errno != ENOSYS) return sock_errno_to_status( errno );
+            TRACE( "sendfile not supported, falling back to read and send\n" );
+            async->no_sendfile = TRUE;
+            break;
+        }
+        TRACE( "sendfile returned %zd\n", ret );
+
+        async->file_cursor += ret;
+        if (async->offset.QuadPart != FILE_USE_FILE_POINTER_POSITION)
+            async->offset.QuadPart += ret;
+        if (!ret || (async->file_len && async->file_cursor == async->file_len))
+            async->file = NULL;
+    }
+#endif
+
     if (async->file && async->buffer_cursor == async->read_len)
     {
         unsigned int read_size = async->buffer_size;
@@ -1505,6 +1562,7 @@ static NTSTATUS sock_transmit( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc,
     async->tail_cursor = 0;
     async->file_len = params->file_len;
     async->flags = params->flags;
+    async->no_sendfile = FALSE;
     async->head = u64_to_user_ptr(params->head_ptr);
     async->head_len = params->head_len;
     async->tail = u64_to_user_ptr(params->tail_ptr);
@@ -2657,6 +2715,45 @@ NTSTATUS sock_ioctl( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc
         case IOCTL_AFD_WINE_SET_TCP_KEEPCNT:
             return do_setsockopt( handle, io, IPPROTO_TCP, TCP_KEEPCNT, in_buffer, in_size );
 
+#ifdef UDP_SEGMENT
+        /* UDP send offload maps directly to generic segmentation offload */
+        case IOCTL_AFD_WINE_GET_UDP_SEND_MSG_SIZE:
+            return do_getsockopt( handle, io, IPPROTO_UDP, UDP_SEGMENT, out_buffer, out_size );
+
+        case IOCTL_AFD_WINE_SET_UDP_SEND_MSG_SIZE:
+            return do_setsockopt( handle, io, IPPROTO_UDP, UDP_SEGMENT, in_buffer, in_size );
+#endif
+
+#ifdef UDP_GRO
+        case IOCTL_AFD_WINE_SET_UDP_RECV_MAX_COALESCED_SIZE:
+        {
+            int value;
+
+            if (in_size < sizeof(DWORD)) return STATUS_BUFFER_TOO_SMALL;
+
+            /* Unix only lets us turn receive coalescing on or off; the kernel
+             * limits coalesced datagrams to 64k, which is also the maximum
+             * value accepted on Windows. */
+            value = !!*(DWORD *)in_buffer;
+            return do_setsockopt( handle, io, IPPROTO_UDP, UDP_GRO, &value, sizeof(value) );
+        }
+
+        case IOCTL_AFD_WINE_GET_UDP_RECV_MAX_COALESCED_SIZE:
+        {
+            NTSTATUS status;
+            int value;
+
+            if (out_size < sizeof(DWORD)) return STATUS_BUFFER_TOO_SMALL;
+
+            /* report the kernel limit when coalescing is enabled, see above */
+            if ((status = do_getsockopt( handle, io, IPPROTO_UDP, UDP_GRO, &value, sizeof(value) )))
+                return status;
+            *(DWORD *)out_buffer = value ? 65535 : 0;
+            io->Information = sizeof(DWORD);
+            return STATUS_SUCCESS;
+        }
+#endif
+
         default:
         {
             if ((code >> 16) == FILE_DEVICE_NETWORK)
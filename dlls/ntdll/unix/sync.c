@@ -2881,22 +2881,36 @@ NTSTATUS WINAPI NtRemoveIoCompletionEx( HANDLE handle, FILE_IO_COMPLETION_INFORM
 
     while (i < count)
     {
+        struct completion_msg msgs[64];
+        ULONG j, wanted = min( count - i - 1, ARRAY_SIZE(msgs) ), got = 0;
+
         SERVER_START_REQ( remove_completion )
         {
             req->handle = wine_server_obj_handle( handle );
             req->alertable = alertable;
+            wine_server_set_reply( req, msgs, wanted * sizeof(*msgs) );
             if (!(status = wine_server_call( req )))
             {
                 info[i].CompletionKey             = reply->ckey;
                 info[i].CompletionValue           = reply->cvalue;
                 info[i].IoStatusBlock.Information = reply->information;
                 info[i].IoStatusBlock.Status      = reply->status;
+                got = wine_server_reply_size( reply ) / sizeof(*msgs);
             }
             else wait_handle = wine_server_ptr_handle( reply->wait_handle );
         }
         SERVER_END_REQ;
         if (status != STATUS_SUCCESS) break;
         ++i;
+        for (j = 0; j < got; j++, i++)
+        {
+            info[i].CompletionKey             = msgs[j].ckey;
+            info[i].CompletionValue           = msgs[j].cvalue;
+            info[i].IoStatusBlock.Information = msgs[j].information;
+            info[i].IoStatusBlock.Status      = msgs[j].status;
+        }
+        /* the port queue is empty, no need to ask again */
+        if (got < wanted) break;
     }
     if (i || (status != STATUS_PENDING && status != STATUS_USER_APC))
     {
@@ -198,6 +198,7 @@ extern const char *home_dir;
 extern const char *data_dir;
 extern const char *build_dir;
 extern const char *config_dir;
+extern const char *server_dir;
 extern const char *wineloader;
 extern const char *user_name;
 extern const char **dll_paths;
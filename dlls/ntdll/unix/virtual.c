@@ -27,6 +27,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <dirent.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
@@ -3026,6 +3027,240 @@ static IMAGE_BASE_RELOCATION *process_relocation_block( char *page, IMAGE_BASE_R
 }
 
 
+/* relocated pages are cached in the server directory, so that all the processes of a prefix
+ * that map an image at the same address can share them instead of relocating it again */
+
+struct reloc_cache_header
+{
+    char     magic[8];     /* RELOC_CACHE_MAGIC */
+    ULONG64  dev;          /* image file identity */
+    ULONG64  ino;
+    ULONG64  file_size;
+    ULONG64  mtime;
+    ULONG64  mtime_nsec;
+    ULONG64  ctime;
+    ULONG64  ctime_nsec;
+    ULONG64  base;         /* image base from the PE header */
+    ULONG64  map_addr;     /* address the image is relocated to */
+    ULONG    machine;
+    ULONG    reloc_size;   /* size of the relocation directory */
+    ULONG64  end;          /* end of the last cached page */
+};
+
+static const char RELOC_CACHE_MAGIC[8] = "WineRlc1";
+
+#define RELOC_CACHE_MAX_FILES 256  /* the cache directory is emptied when it grows beyond this */
+
+/***********************************************************************
+ *           init_reloc_cache_header
+ */
+static void init_reloc_cache_header( struct reloc_cache_header *header, const struct stat *st,
+                                     const struct pe_image_info *image_info, const IMAGE_DATA_DIRECTORY *dir )
+{
+    memset( header, 0, sizeof(*header) );
+    memcpy( header->magic, RELOC_CACHE_MAGIC, sizeof(header->magic) );
+    header->dev        = st->st_dev;
+    header->ino        = st->st_ino;
+    header->file_size  = st->st_size;
+    header->mtime      = st->st_mtime;
+    header->ctime      = st->st_ctime;
+#ifdef HAVE_STRUCT_STAT_ST_MTIM
+    header->mtime_nsec = st->st_mtim.tv_nsec;
+#elif defined(HAVE_STRUCT_STAT_ST_MTIMESPEC)
+    header->mtime_nsec = st->st_mtimespec.tv_nsec;
+#endif
+#ifdef HAVE_STRUCT_STAT_ST_CTIM
+    header->ctime_nsec = st->st_ctim.tv_nsec;
+#elif defined(HAVE_STRUCT_STAT_ST_CTIMESPEC)
+    header->ctime_nsec = st->st_ctimespec.tv_nsec;
+#endif
+    header->base       = image_info->base;
+    header->map_addr   = image_info->map_addr;
+    header->machine    = image_info->machine;
+    header->reloc_size = dir->Size;
+}
+
+/***********************************************************************
+ *           get_reloc_cache_name
+ */
+static char *get_reloc_cache_name( const struct reloc_cache_header *header )
+{
+    char *name;
+
+    if (!server_dir) return NULL;
+    if (asprintf( &name, "%s/reloc/%llx-%llx-%llx-%04x", server_dir, (unsigned long long)header->dev,
+                  (unsigned long long)header->ino, (unsigned long long)header->map_addr,
+                  (int)header->machine ) == -1)
+        return NULL;
+    return name;
+}
+
+/***********************************************************************
+ *           next_relocation_range
+ *
+ * Return the next range of host pages modified by the relocation blocks.
+ */
+static BOOL next_relocation_range( IMAGE_BASE_RELOCATION **rel_ptr, IMAGE_BASE_RELOCATION *end,
+                                   SIZE_T total_size, SIZE_T *start, SIZE_T *size )
+{
+    IMAGE_BASE_RELOCATION *rel = *rel_ptr;
+    SIZE_T range_start = 0, range_end = 0, block_start, block_end;
+
+    while (rel < end - 1 && rel->SizeOfBlock && rel->VirtualAddress < total_size)
+    {
+        /* a block covers a 4k page, a fixup at the end of it may extend into the next one */
+        block_start = rel->VirtualAddress & ~host_page_mask;
+        block_end = min( ROUND_SIZE( 0, rel->VirtualAddress + 0x1000 + sizeof(INT64), host_page_mask ),
+                         total_size );
+        if (range_end && (block_start > range_end || block_end < range_start)) break;
+        if (!range_end || block_start < range_start) range_start = block_start;
+        if (block_end > range_end) range_end = block_end;
+        rel = (IMAGE_BASE_RELOCATION *)((char *)rel + rel->SizeOfBlock);
+    }
+    *rel_ptr = rel;
+    *start = range_start;
+    *size = range_end - range_start;
+    return range_end != 0;
+}
+
+/***********************************************************************
+ *           load_reloc_cache
+ *
+ * Map the cached relocated pages of an image, if available.
+ * On failure, rel_ptr is updated to the first relocation block that still needs to be applied.
+ * virtual_mutex must be held by caller.
+ */
+static NTSTATUS load_reloc_cache( struct file_view *view, const struct stat *st,
+                                  const struct pe_image_info *image_info, const IMAGE_DATA_DIRECTORY *dir,
+                                  IMAGE_BASE_RELOCATION **rel_ptr )
+{
+    IMAGE_BASE_RELOCATION *rel = *rel_ptr, *next;
+    IMAGE_BASE_RELOCATION *end = (IMAGE_BASE_RELOCATION *)((char *)rel + dir->Size);
+    struct reloc_cache_header header, expect;
+    struct stat cache_st;
+    SIZE_T start, size;
+    NTSTATUS status = STATUS_SUCCESS;
+    char *name;
+    int fd;
+
+    init_reloc_cache_header( &expect, st, image_info, dir );
+    if (!(name = get_reloc_cache_name( &expect ))) return STATUS_NOT_FOUND;
+    if ((fd = open( name, O_RDONLY | O_CLOEXEC )) == -1)
+    {
+        free( name );
+        return STATUS_NOT_FOUND;
+    }
+
+    if (pread( fd, &header, sizeof(header), 0 ) == sizeof(header) && !fstat( fd, &cache_st ))
+    {
+        expect.end = header.end;
+        if (memcmp( &header, &expect, sizeof(header) ) || cache_st.st_size < header.end ||
+            header.end > view->size)
+            status = STATUS_NOT_FOUND;
+    }
+    else status = STATUS_NOT_FOUND;
+
+    /* check all the ranges before mapping anything, so that the image can still be relocated in place */
+    next = rel;
+    while (!status && next_relocation_range( &next, end, view->size, &start, &size ))
+        if (!start || start + size > header.end) status = STATUS_NOT_FOUND;
+
+    if (status)
+    {
+        /* the image has been modified in place, the cache file will be written again */
+        TRACE_(module)( "removing stale relocation cache %s\n", debugstr_a(name) );
+        unlink( name );
+    }
+    free( name );
+
+    next = rel;
+    while (!status && next_relocation_range( &next, end, view->size, &start, &size ))
+    {
+        if (!(status = map_file_into_view( view, fd, start, size, start,
+                                           VPROT_COMMITTED | VPROT_READ | VPROT_WRITECOPY, FALSE )))
+            rel = next;
+    }
+    close( fd );
+    *rel_ptr = rel;
+    return status;
+}
+
+/***********************************************************************
+ *           prepare_reloc_cache_dir
+ *
+ * Create the cache directory, or empty it if it contains too many files.
+ * Files are only ever replaced atomically, so this is safe to do concurrently.
+ */
+static void prepare_reloc_cache_dir( const char *name )
+{
+    char *dir_name = strdup( name ), *p;
+    unsigned int count = 0;
+    struct dirent *de;
+    DIR *dir;
+
+    if (!dir_name) return;
+    if ((p = strrchr( dir_name, '/' ))) *p = 0;
+
+    if ((dir = opendir( dir_name )))
+    {
+        while ((de = readdir( dir ))) if (de->d_name[0] != '.') count++;
+        if (count >= RELOC_CACHE_MAX_FILES)
+        {
+            TRACE_(module)( "removing %u files from %s\n", count, debugstr_a(dir_name) );
+            rewinddir( dir );
+            while ((de = readdir( dir ))) if (de->d_name[0] != '.') unlinkat( dirfd( dir ), de->d_name, 0 );
+        }
+        closedir( dir );
+    }
+    else mkdir( dir_name, 0700 );
+    free( dir_name );
+}
+
+/***********************************************************************
+ *           save_reloc_cache
+ *
+ * Store the relocated pages of an image for other processes to use.
+ */
+static void save_reloc_cache( struct file_view *view, const struct stat *st,
+                              const struct pe_image_info *image_info, const IMAGE_DATA_DIRECTORY *dir )
+{
+    IMAGE_BASE_RELOCATION *rel = (IMAGE_BASE_RELOCATION *)((char *)view->base + dir->VirtualAddress);
+    IMAGE_BASE_RELOCATION *end = (IMAGE_BASE_RELOCATION *)((char *)rel + dir->Size);
+    struct reloc_cache_header header;
+    SIZE_T start, size;
+    char *name, *tmp_name;
+    BOOL ret = TRUE;
+    int fd;
+
+    init_reloc_cache_header( &header, st, image_info, dir );
+    if (!(name = get_reloc_cache_name( &header ))) return;
+    if (asprintf( &tmp_name, "%s.%x", name, (int)getpid() ) == -1)
+    {
+        free( name );
+        return;
+    }
+    prepare_reloc_cache_dir( name );
+
+    if ((fd = open( tmp_name, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600 )) != -1)
+    {
+        while (ret && next_relocation_range( &rel, end, view->size, &start, &size ))
+        {
+            /* the first page holds the cache header */
+            ret = start && pwrite( fd, (char *)view->base + start, size, start ) == size;
+            header.end = max( header.end, start + size );
+        }
+        ret = ret && header.end && pwrite( fd, &header, sizeof(header), 0 ) == sizeof(header);
+        close( fd );
+        if (ret && !rename( tmp_name, name ))
+            TRACE_(module)( "cached relocations in %s\n", debugstr_a(name) );
+        else
+            unlink( tmp_name );
+    }
+    free( tmp_name );
+    free( name );
+}
+
+
 /***********************************************************************
  *           map_image_into_view
  *
@@ -3233,9 +3468,21 @@ static NTSTATUS map_image_into_view( struct file_view *view, const UNICODE_STRIN
         {
             IMAGE_BASE_RELOCATION *rel = (IMAGE_BASE_RELOCATION *)(ptr + dir->VirtualAddress);
             IMAGE_BASE_RELOCATION *end = (IMAGE_BASE_RELOCATION *)((char *)rel + dir->Size);
+            NTSTATUS cache_status = STATUS_NOT_SUPPORTED;
+
+            /* images with shared sections or loaded from removable media are not cached */
+            if (shared_fd == -1 && !removable)
+                cache_status = load_reloc_cache( view, &st, image_info, dir, &rel );
 
-            while (rel && rel < end - 1 && rel->SizeOfBlock && rel->VirtualAddress < total_size)
-                rel = process_relocation_block( ptr + rel->VirtualAddress, rel, delta );
+            if (!cache_status)
+                TRACE_(module)( "using cached relocations for %s\n", debugstr_us(nt_name) );
+            else
+            {
+                /* relocate in place what could not be mapped from the cache */
+                while (rel && rel < end - 1 && rel->SizeOfBlock && rel->VirtualAddress < total_size)
+                    rel = process_relocation_block( ptr + rel->VirtualAddress, rel, delta );
+                if (cache_status == STATUS_NOT_FOUND && rel) save_reloc_cache( view, &st, image_info, dir );
+            }
         }
     }
 
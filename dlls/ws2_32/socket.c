@@ -27,6 +27,7 @@
  */
 
 #include "ws2_32_private.h"
+#include "wine/list.h"
 
 #define FILE_USE_FILE_POINTER_POSITION ((LONGLONG)-2)
 
@@ -428,6 +429,14 @@ static inline const char *debugstr_sockopt(int level, int optname)
         }
         break;
 
+        DEBUG_SOCKLEVEL(IPPROTO_UDP);
+        switch(optname)
+        {
+            DEBUG_SOCKOPT(UDP_SEND_MSG_SIZE);
+            DEBUG_SOCKOPT(UDP_RECV_MAX_COALESCED_SIZE);
+        }
+        break;
+
         DEBUG_SOCKLEVEL(IPPROTO_IP);
         switch(optname)
         {
@@ -589,6 +598,7 @@ static FARPROC blocking_hook = (FARPROC)WSA_DefaultBlockingHook;
 
 /* function prototypes */
 static int ws_protocol_info(SOCKET s, int unicode, WSAPROTOCOL_INFOW *buffer, int *size);
+static void rio_socket_closed( SOCKET s );
 
 static DWORD NtStatusToWSAError( NTSTATUS status )
 {
@@ -1359,6 +1369,7 @@ int WINAPI closesocket( SOCKET s )
         return -1;
     }
 
+    rio_socket_closed( s );
     CloseHandle( (HANDLE)s );
     return 0;
 }
@@ -1658,6 +1669,618 @@ static BOOL WINAPI WS2_DisconnectEx( SOCKET s, OVERLAPPED *overlapped, DWORD fla
     return !status;
 }
 
+/***********************************************************************
+ * Registered I/O extension functions
+ *
+ * Requests are submitted as overlapped sends and receives with a private
+ * event, which keeps their completions off any port the application bound
+ * the socket to. A thread pool wait on that event queues the result on the
+ * RIO completion queue, from which the application dequeues it. The request
+ * slots, with their event and wait, are allocated with the request queue and
+ * recycled as requests complete.
+ */
+
+struct rio_buffer
+{
+    char *data;
+    DWORD size;
+};
+
+struct rio_cq
+{
+    CRITICAL_SECTION cs;
+    RIORESULT *results;     /* ring buffer of completed requests */
+    ULONG size;             /* size of the ring buffer */
+    ULONG head;             /* index of the oldest result */
+    ULONG count;            /* number of queued results */
+    BOOL corrupt;           /* the queue overflowed */
+    BOOL armed;             /* a notification was requested with RIONotify */
+    BOOL has_notify;
+    RIO_NOTIFICATION_COMPLETION notify;
+};
+
+struct rio_rq
+{
+    struct list entry;      /* entry in rio_rq_list */
+    LONG refcount;
+    CRITICAL_SECTION cs;    /* protects the request slot lists */
+    struct list requests;   /* all the request slots */
+    struct rio_request *free_requests; /* stack of unused request slots */
+    ULONG request_count;    /* number of request slots */
+    SOCKET socket;
+    void *context;          /* socket context for the completion results */
+    struct rio_cq *recv_cq;
+    struct rio_cq *send_cq;
+    ULONG max_recv;         /* maximum number of outstanding receives */
+    ULONG max_send;         /* maximum number of outstanding sends */
+    LONG recv_count;        /* number of outstanding receives */
+    LONG send_count;        /* number of outstanding sends */
+};
+
+struct rio_request
+{
+    OVERLAPPED ovl;
+    HANDLE event;
+    TP_WAIT *wait;
+    struct list entry;      /* entry in the request queue slot list */
+    struct rio_request *next_free;
+    struct rio_rq *rq;
+    void *context;
+    BOOL send;
+    BOOL notify;
+    WSABUF buf;
+    DWORD flags;
+    int addr_len;
+};
+
+static struct list rio_rq_list = LIST_INIT( rio_rq_list );
+
+DECLARE_CRITICAL_SECTION(cs_rio_rq_list);
+
+static void rio_request_free( struct rio_request *request )
+{
+    if (request->wait) CloseThreadpoolWait( request->wait );
+    if (request->event) CloseHandle( request->event );
+    free( request );
+}
+
+static void rio_rq_release( struct rio_rq *rq )
+{
+    struct rio_request *request, *next;
+
+    if (InterlockedDecrement( &rq->refcount )) return;
+    LIST_FOR_EACH_ENTRY_SAFE( request, next, &rq->requests, struct rio_request, entry )
+        rio_request_free( request );
+    rq->cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection( &rq->cs );
+    free( rq );
+}
+
+static void CALLBACK rio_wait_callback( TP_CALLBACK_INSTANCE *instance, void *context, TP_WAIT *wait,
+                                        TP_WAIT_RESULT wait_result );
+
+/* grow the request slots to count, the rq critical section must be held or the rq not yet published */
+static BOOL rio_rq_alloc_requests( struct rio_rq *rq, ULONG count )
+{
+    struct rio_request *request;
+
+    while (rq->request_count < count)
+    {
+        if (!(request = calloc( 1, sizeof(*request) ))) return FALSE;
+        if (!(request->event = CreateEventW( NULL, FALSE, FALSE, NULL )) ||
+            !(request->wait = CreateThreadpoolWait( rio_wait_callback, request, NULL )))
+        {
+            rio_request_free( request );
+            return FALSE;
+        }
+        request->rq = rq;
+        request->ovl.hEvent = (HANDLE)((ULONG_PTR)request->event | 1);
+        list_add_tail( &rq->requests, &request->entry );
+        request->next_free = rq->free_requests;
+        rq->free_requests = request;
+        rq->request_count++;
+    }
+    return TRUE;
+}
+
+/* called when a socket is closed to drop its request queue */
+static void rio_socket_closed( SOCKET s )
+{
+    struct rio_rq *rq, *found = NULL;
+
+    EnterCriticalSection( &cs_rio_rq_list );
+    LIST_FOR_EACH_ENTRY( rq, &rio_rq_list, struct rio_rq, entry )
+    {
+        if (rq->socket != s) continue;
+        list_remove( &rq->entry );
+        found = rq;
+        break;
+    }
+    LeaveCriticalSection( &cs_rio_rq_list );
+
+    if (found) rio_rq_release( found );
+}
+
+static void rio_cq_notify( struct rio_cq *cq )
+{
+    if (cq->notify.Type == RIO_EVENT_COMPLETION)
+        SetEvent( cq->notify.Event.EventHandle );
+    else
+        PostQueuedCompletionStatus( cq->notify.Iocp.IocpHandle, 0, (ULONG_PTR)cq->notify.Iocp.CompletionKey,
+                                    cq->notify.Iocp.Overlapped );
+}
+
+static void rio_cq_add_result( struct rio_cq *cq, const RIORESULT *result, BOOL notify )
+{
+    EnterCriticalSection( &cq->cs );
+    if (cq->count == cq->size)
+    {
+        ERR( "completion queue %p overflow\n", cq );
+        cq->corrupt = TRUE;
+    }
+    else cq->results[(cq->head + cq->count++) % cq->size] = *result;
+    notify = notify && cq->armed;
+    if (notify) cq->armed = FALSE;
+    LeaveCriticalSection( &cq->cs );
+
+    if (notify) rio_cq_notify( cq );
+}
+
+static void CALLBACK rio_wait_callback( TP_CALLBACK_INSTANCE *instance, void *context, TP_WAIT *wait,
+                                        TP_WAIT_RESULT wait_result )
+{
+    struct rio_request *request = context;
+    struct rio_rq *rq = request->rq;
+    RIORESULT result;
+    BOOL send, notify;
+
+    TRACE( "request %p, status %#Ix, size %Iu\n", request, request->ovl.Internal, request->ovl.InternalHigh );
+
+    result.Status = NtStatusToWSAError( request->ovl.Internal );
+    result.BytesTransferred = request->ovl.InternalHigh;
+    result.SocketContext = (ULONG_PTR)rq->context;
+    result.RequestContext = (ULONG_PTR)request->context;
+    send = request->send;
+    notify = request->notify;
+
+    /* recycle the slot first, so that the request can be resubmitted as soon as it's dequeued */
+    EnterCriticalSection( &rq->cs );
+    request->next_free = rq->free_requests;
+    rq->free_requests = request;
+    LeaveCriticalSection( &rq->cs );
+
+    if (send)
+    {
+        InterlockedDecrement( &rq->send_count );
+        rio_cq_add_result( rq->send_cq, &result, notify );
+    }
+    else
+    {
+        InterlockedDecrement( &rq->recv_count );
+        rio_cq_add_result( rq->recv_cq, &result, notify );
+    }
+
+    rio_rq_release( rq );
+}
+
+static char *get_rio_buf_ptr( const RIO_BUF *buf )
+{
+    struct rio_buffer *buffer = (struct rio_buffer *)buf->BufferId;
+
+    if (!buffer || buf->BufferId == RIO_INVALID_BUFFERID) return NULL;
+    if (buf->Offset > buffer->size || buf->Length > buffer->size - buf->Offset) return NULL;
+    return buffer->data + buf->Offset;
+}
+
+static BOOL rio_submit( RIO_RQ queue, BOOL send, RIO_BUF *data, ULONG count, RIO_BUF *remote,
+                        DWORD flags, void *context )
+{
+    struct rio_rq *rq = (struct rio_rq *)queue;
+    struct rio_request *request;
+    struct sockaddr *addr = NULL;
+    WSABUF buf = {0};
+    int addr_len = 0;
+    LONG *pending;
+    ULONG max;
+    int ret;
+
+    if (!rq)
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+    if (flags & RIO_MSG_DEFER)
+    {
+        static int once;
+        if (!once++) FIXME( "deferred requests are started immediately\n" );
+    }
+    /* deferred requests are started right away, so there's nothing to commit */
+    if (flags & RIO_MSG_COMMIT_ONLY)
+    {
+        if (!count) return TRUE;
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+    if (count > 1 || (count && !data))
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+    if (count)
+    {
+        if (!(buf.buf = get_rio_buf_ptr( data )))
+        {
+            SetLastError( WSAEINVAL );
+            return FALSE;
+        }
+        buf.len = data->Length;
+    }
+    if (remote)
+    {
+        if (!(addr = (struct sockaddr *)get_rio_buf_ptr( remote )))
+        {
+            SetLastError( WSAEINVAL );
+            return FALSE;
+        }
+        addr_len = remote->Length;
+    }
+
+    pending = send ? &rq->send_count : &rq->recv_count;
+    max = send ? rq->max_send : rq->max_recv;
+    if (InterlockedIncrement( pending ) > max)
+    {
+        InterlockedDecrement( pending );
+        SetLastError( WSAENOBUFS );
+        return FALSE;
+    }
+
+    EnterCriticalSection( &rq->cs );
+    if ((request = rq->free_requests)) rq->free_requests = request->next_free;
+    LeaveCriticalSection( &rq->cs );
+    if (!request)
+    {
+        InterlockedDecrement( pending );
+        SetLastError( WSAENOBUFS );
+        return FALSE;
+    }
+
+    request->ovl.Internal = request->ovl.InternalHigh = 0;
+    request->ovl.Offset = request->ovl.OffsetHigh = 0;
+    request->context = context;
+    request->send = send;
+    request->notify = !(flags & RIO_MSG_DONT_NOTIFY);
+    request->buf = buf;
+    request->addr_len = addr_len;
+    request->flags = (!send && (flags & RIO_MSG_WAITALL)) ? MSG_WAITALL : 0;
+    InterlockedIncrement( &rq->refcount );
+
+    /* the low bit of the event keeps the completion off the socket's completion port */
+    SetThreadpoolWait( request->wait, request->event, NULL );
+
+    if (send)
+        ret = WSASendTo( rq->socket, &request->buf, 1, NULL, 0, addr, request->addr_len,
+                         &request->ovl, NULL );
+    else
+        ret = WSARecvFrom( rq->socket, &request->buf, 1, NULL, &request->flags, addr,
+                           addr ? &request->addr_len : NULL, &request->ovl, NULL );
+
+    if (ret && (ret = WSAGetLastError()) != WSA_IO_PENDING)
+    {
+        SetThreadpoolWait( request->wait, NULL, NULL );
+        WaitForThreadpoolWaitCallbacks( request->wait, TRUE );
+        EnterCriticalSection( &rq->cs );
+        request->next_free = rq->free_requests;
+        rq->free_requests = request;
+        LeaveCriticalSection( &rq->cs );
+        InterlockedDecrement( pending );
+        rio_rq_release( rq );
+        SetLastError( ret );
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static BOOL WINAPI WS2_RIOReceive( RIO_RQ queue, RIO_BUF *data, ULONG count, DWORD flags, void *context )
+{
+    TRACE( "queue %p, data %p, count %lu, flags %#lx, context %p\n", queue, data, count, flags, context );
+
+    return rio_submit( queue, FALSE, data, count, NULL, flags, context );
+}
+
+static int WINAPI WS2_RIOReceiveEx( RIO_RQ queue, RIO_BUF *data, ULONG count, RIO_BUF *local_addr,
+                                    RIO_BUF *remote_addr, RIO_BUF *control, RIO_BUF *msg_flags,
+                                    DWORD flags, void *context )
+{
+    TRACE( "queue %p, data %p, count %lu, local_addr %p, remote_addr %p, control %p, msg_flags %p, "
+           "flags %#lx, context %p\n", queue, data, count, local_addr, remote_addr, control, msg_flags,
+           flags, context );
+
+    if (local_addr || control || msg_flags)
+        FIXME( "local address, control and flags buffers not supported\n" );
+
+    return rio_submit( queue, FALSE, data, count, remote_addr, flags, context );
+}
+
+static BOOL WINAPI WS2_RIOSend( RIO_RQ queue, RIO_BUF *data, ULONG count, DWORD flags, void *context )
+{
+    TRACE( "queue %p, data %p, count %lu, flags %#lx, context %p\n", queue, data, count, flags, context );
+
+    return rio_submit( queue, TRUE, data, count, NULL, flags, context );
+}
+
+static BOOL WINAPI WS2_RIOSendEx( RIO_RQ queue, RIO_BUF *data, ULONG count, RIO_BUF *local_addr,
+                                  RIO_BUF *remote_addr, RIO_BUF *control, RIO_BUF *msg_flags,
+                                  DWORD flags, void *context )
+{
+    TRACE( "queue %p, data %p, count %lu, local_addr %p, remote_addr %p, control %p, msg_flags %p, "
+           "flags %#lx, context %p\n", queue, data, count, local_addr, remote_addr, control, msg_flags,
+           flags, context );
+
+    if (local_addr || control || msg_flags)
+        FIXME( "local address, control and flags buffers not supported\n" );
+
+    return rio_submit( queue, TRUE, data, count, remote_addr, flags, context );
+}
+
+static void WINAPI WS2_RIOCloseCompletionQueue( RIO_CQ queue )
+{
+    struct rio_cq *cq = (struct rio_cq *)queue;
+
+    TRACE( "queue %p\n", queue );
+
+    if (!cq) return;
+    cq->cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection( &cq->cs );
+    free( cq->results );
+    free( cq );
+}
+
+static RIO_CQ WINAPI WS2_RIOCreateCompletionQueue( DWORD size, RIO_NOTIFICATION_COMPLETION *notify )
+{
+    struct rio_cq *cq;
+
+    TRACE( "size %lu, notify %p\n", size, notify );
+
+    if (!size || size > RIO_MAX_CQ_SIZE ||
+        (notify && notify->Type != RIO_EVENT_COMPLETION && notify->Type != RIO_IOCP_COMPLETION))
+    {
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_CQ;
+    }
+    if (!(cq = calloc( 1, sizeof(*cq) )) || !(cq->results = malloc( size * sizeof(*cq->results) )))
+    {
+        free( cq );
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_CQ;
+    }
+    cq->size = size;
+    if (notify)
+    {
+        cq->has_notify = TRUE;
+        cq->notify = *notify;
+    }
+    InitializeCriticalSection( &cq->cs );
+    cq->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": rio_cq.cs");
+    return (RIO_CQ)cq;
+}
+
+static RIO_RQ WINAPI WS2_RIOCreateRequestQueue( SOCKET s, ULONG max_recv, ULONG max_recv_buffers,
+                                                ULONG max_send, ULONG max_send_buffers,
+                                                RIO_CQ recv_cq, RIO_CQ send_cq, void *context )
+{
+    struct rio_rq *rq, *other;
+
+    TRACE( "socket %#Ix, max_recv %lu, max_recv_buffers %lu, max_send %lu, max_send_buffers %lu, "
+           "recv_cq %p, send_cq %p, context %p\n", s, max_recv, max_recv_buffers, max_send,
+           max_send_buffers, recv_cq, send_cq, context );
+
+    if (!is_valid_socket( s ))
+    {
+        SetLastError( WSAENOTSOCK );
+        return RIO_INVALID_RQ;
+    }
+    /* only a single data buffer per request is supported, like on Windows */
+    if (!recv_cq || !send_cq || !max_recv || !max_send || max_recv_buffers != 1 || max_send_buffers != 1)
+    {
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_RQ;
+    }
+    if (!(rq = calloc( 1, sizeof(*rq) )))
+    {
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_RQ;
+    }
+    rq->refcount = 1;
+    InitializeCriticalSection( &rq->cs );
+    rq->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": rio_rq.cs");
+    list_init( &rq->requests );
+    if (!rio_rq_alloc_requests( rq, max_recv + max_send ))
+    {
+        rio_rq_release( rq );
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_RQ;
+    }
+    rq->socket = s;
+    rq->context = context;
+    rq->recv_cq = (struct rio_cq *)recv_cq;
+    rq->send_cq = (struct rio_cq *)send_cq;
+    rq->max_recv = max_recv;
+    rq->max_send = max_send;
+
+    EnterCriticalSection( &cs_rio_rq_list );
+    LIST_FOR_EACH_ENTRY( other, &rio_rq_list, struct rio_rq, entry )
+    {
+        if (other->socket != s) continue;
+        LeaveCriticalSection( &cs_rio_rq_list );
+        rio_rq_release( rq );
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_RQ;
+    }
+    list_add_tail( &rio_rq_list, &rq->entry );
+    LeaveCriticalSection( &cs_rio_rq_list );
+
+    return (RIO_RQ)rq;
+}
+
+static ULONG WINAPI WS2_RIODequeueCompletion( RIO_CQ queue, RIORESULT *results, ULONG size )
+{
+    struct rio_cq *cq = (struct rio_cq *)queue;
+    ULONG i, count;
+
+    TRACE( "queue %p, results %p, size %lu\n", queue, results, size );
+
+    if (!cq || !results) return RIO_CORRUPT_CQ;
+
+    EnterCriticalSection( &cq->cs );
+    if (cq->corrupt)
+    {
+        LeaveCriticalSection( &cq->cs );
+        return RIO_CORRUPT_CQ;
+    }
+    count = min( size, cq->count );
+    for (i = 0; i < count; i++)
+    {
+        results[i] = cq->results[cq->head];
+        cq->head = (cq->head + 1) % cq->size;
+    }
+    cq->count -= count;
+    LeaveCriticalSection( &cq->cs );
+
+    return count;
+}
+
+static void WINAPI WS2_RIODeregisterBuffer( RIO_BUFFERID id )
+{
+    TRACE( "id %p\n", id );
+
+    if (id == RIO_INVALID_BUFFERID) return;
+    free( id );
+}
+
+static int WINAPI WS2_RIONotify( RIO_CQ queue )
+{
+    struct rio_cq *cq = (struct rio_cq *)queue;
+    BOOL notify;
+
+    TRACE( "queue %p\n", queue );
+
+    if (!cq || !cq->has_notify) return WSAEINVAL;
+
+    if (cq->notify.Type == RIO_EVENT_COMPLETION && cq->notify.Event.NotifyReset)
+        ResetEvent( cq->notify.Event.EventHandle );
+
+    EnterCriticalSection( &cq->cs );
+    if (cq->armed)
+    {
+        LeaveCriticalSection( &cq->cs );
+        return WSAEALREADY;
+    }
+    if (!(notify = cq->count > 0)) cq->armed = TRUE;
+    LeaveCriticalSection( &cq->cs );
+
+    if (notify) rio_cq_notify( cq );
+    return ERROR_SUCCESS;
+}
+
+static RIO_BUFFERID WINAPI WS2_RIORegisterBuffer( char *data, DWORD size )
+{
+    struct rio_buffer *buffer;
+
+    TRACE( "data %p, size %lu\n", data, size );
+
+    if (!data)
+    {
+        SetLastError( WSAEFAULT );
+        return RIO_INVALID_BUFFERID;
+    }
+    if (!(buffer = malloc( sizeof(*buffer) )))
+    {
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_BUFFERID;
+    }
+    buffer->data = data;
+    buffer->size = size;
+    return (RIO_BUFFERID)buffer;
+}
+
+static BOOL WINAPI WS2_RIOResizeCompletionQueue( RIO_CQ queue, DWORD size )
+{
+    struct rio_cq *cq = (struct rio_cq *)queue;
+    RIORESULT *results;
+    ULONG i;
+
+    TRACE( "queue %p, size %lu\n", queue, size );
+
+    if (!cq || !size || size > RIO_MAX_CQ_SIZE)
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+
+    EnterCriticalSection( &cq->cs );
+    if (size < cq->count)
+    {
+        LeaveCriticalSection( &cq->cs );
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+    if (!(results = malloc( size * sizeof(*results) )))
+    {
+        LeaveCriticalSection( &cq->cs );
+        SetLastError( WSAENOBUFS );
+        return FALSE;
+    }
+    for (i = 0; i < cq->count; i++) results[i] = cq->results[(cq->head + i) % cq->size];
+    free( cq->results );
+    cq->results = results;
+    cq->size = size;
+    cq->head = 0;
+    LeaveCriticalSection( &cq->cs );
+    return TRUE;
+}
+
+static BOOL WINAPI WS2_RIOResizeRequestQueue( RIO_RQ queue, DWORD max_recv, DWORD max_send )
+{
+    struct rio_rq *rq = (struct rio_rq *)queue;
+
+    TRACE( "queue %p, max_recv %lu, max_send %lu\n", queue, max_recv, max_send );
+
+    if (!rq || !max_recv || !max_send)
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+
+    EnterCriticalSection( &rq->cs );
+    if (!rio_rq_alloc_requests( rq, max_recv + max_send ))
+    {
+        LeaveCriticalSection( &rq->cs );
+        SetLastError( WSAENOBUFS );
+        return FALSE;
+    }
+    rq->max_recv = max_recv;
+    rq->max_send = max_send;
+    LeaveCriticalSection( &rq->cs );
+    return TRUE;
+}
+
+static const RIO_EXTENSION_FUNCTION_TABLE rio_functions =
+{
+    sizeof(RIO_EXTENSION_FUNCTION_TABLE),
+    WS2_RIOReceive,
+    WS2_RIOReceiveEx,
+    WS2_RIOSend,
+    WS2_RIOSendEx,
+    WS2_RIOCloseCompletionQueue,
+    WS2_RIOCreateCompletionQueue,
+    WS2_RIOCreateRequestQueue,
+    WS2_RIODequeueCompletion,
+    WS2_RIODeregisterBuffer,
+    WS2_RIONotify,
+    WS2_RIORegisterBuffer,
+    WS2_RIOResizeCompletionQueue,
+    WS2_RIOResizeRequestQueue,
+};
 
 /***********************************************************************
  *      getpeername   (ws2_32.5)
@@ -2119,6 +2742,35 @@ int WINAPI getsockopt( SOCKET s, int level, int optname, char *optval, int *optl
             return -1;
         }
 
+    case IPPROTO_UDP:
+        switch(optname)
+        {
+        case UDP_SEND_MSG_SIZE:
+            if (*optlen < sizeof(DWORD) || !optval)
+            {
+                *optlen = 0;
+                SetLastError( WSAEFAULT );
+                return SOCKET_ERROR;
+            }
+            *optlen = sizeof(DWORD);
+            return server_getsockopt( s, IOCTL_AFD_WINE_GET_UDP_SEND_MSG_SIZE, optval, optlen );
+
+        case UDP_RECV_MAX_COALESCED_SIZE:
+            if (*optlen < sizeof(DWORD) || !optval)
+            {
+                *optlen = 0;
+                SetLastError( WSAEFAULT );
+                return SOCKET_ERROR;
+            }
+            *optlen = sizeof(DWORD);
+            return server_getsockopt( s, IOCTL_AFD_WINE_GET_UDP_RECV_MAX_COALESCED_SIZE, optval, optlen );
+
+        default:
+            FIXME( "unrecognized UDP option %#x\n", optname );
+            SetLastError( WSAENOPROTOOPT );
+            return -1;
+        }
+
     case IPPROTO_IP:
         switch(optname)
         {
@@ -2321,6 +2973,7 @@ static const char *debugstr_wsaioctl(DWORD code)
         IOCTL_NAME(SIO_FLUSH);
         IOCTL_NAME(SIO_GET_BROADCAST_ADDRESS);
         IOCTL_NAME(SIO_GET_EXTENSION_FUNCTION_POINTER);
+        IOCTL_NAME(SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER);
         IOCTL_NAME(SIO_GET_GROUP_QOS);
         IOCTL_NAME(SIO_GET_INTERFACE_LIST);
         /* IOCTL_NAME(SIO_GET_INTERFACE_LIST_EX); */
@@ -2696,6 +3349,35 @@ INT WINAPI WSAIoctl(SOCKET s, DWORD code, LPVOID in_buff, DWORD in_size, LPVOID
         return -1;
     }
 
+    case SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER:
+    {
+        static const GUID rio_guid = WSAID_MULTIPLE_RIO;
+        NTSTATUS status = STATUS_SUCCESS;
+        DWORD ret;
+
+        if (!in_buff || in_size < sizeof(GUID) || !IsEqualGUID( &rio_guid, in_buff ))
+        {
+            FIXME( "SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER %s: stub\n",
+                   in_buff && in_size >= sizeof(GUID) ? debugstr_guid(in_buff) : "(invalid)" );
+            SetLastError( WSAEINVAL );
+            return -1;
+        }
+        if (!out_buff || out_size < sizeof(rio_functions))
+        {
+            SetLastError( WSAEFAULT );
+            return -1;
+        }
+
+        TRACE( "returning RIO function table\n" );
+        memcpy( out_buff, &rio_functions, sizeof(rio_functions) );
+
+        ret = server_ioctl_sock( s, IOCTL_AFD_WINE_COMPLETE_ASYNC, &status, sizeof(status),
+                                 NULL, 0, ret_size, overlapped, completion );
+        *ret_size = sizeof(rio_functions);
+        SetLastError( ret );
+        return ret ? -1 : 0;
+    }
+
     case SIO_KEEPALIVE_VALS:
     {
         DWORD ret;
@@ -3559,6 +4241,34 @@ int WINAPI setsockopt( SOCKET s, int level, int optname, const char *optval, int
         }
         break;
 
+    case IPPROTO_UDP:
+        switch(optname)
+        {
+        case UDP_SEND_MSG_SIZE:
+            if (optlen < sizeof(DWORD) || !optval)
+            {
+                SetLastError( WSAEFAULT );
+                return SOCKET_ERROR;
+            }
+            value = *(DWORD *)optval;
+            return server_setsockopt( s, IOCTL_AFD_WINE_SET_UDP_SEND_MSG_SIZE, (char *)&value, sizeof(value) );
+
+        case UDP_RECV_MAX_COALESCED_SIZE:
+            if (optlen < sizeof(DWORD) || !optval)
+            {
+                SetLastError( WSAEFAULT );
+                return SOCKET_ERROR;
+            }
+            value = *(DWORD *)optval;
+            return server_setsockopt( s, IOCTL_AFD_WINE_SET_UDP_RECV_MAX_COALESCED_SIZE, (char *)&value, sizeof(value) );
+
+        default:
+            FIXME("Unknown IPPROTO_UDP optname 0x%08x\n", optname);
+            SetLastError(WSAENOPROTOOPT);
+            return SOCKET_ERROR;
+        }
+        break;
+
     case IPPROTO_IP:
         if (optlen < 0)
         {
@@ -14522,6 +14522,75 @@ static void test_tcp_sendto_recvfrom(void)
     closesocket(server);
 }
 
+static void test_udp_send_offload(void)
+{
+    const struct sockaddr_in bind_addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    char buffer[300], recv_buffer[300];
+    struct sockaddr_in addr;
+    SOCKET client, server;
+    DWORD value;
+    int ret, len, i;
+
+    client = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    server = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+    value = 100;
+    ret = setsockopt(client, IPPROTO_UDP, UDP_SEND_MSG_SIZE, (char *)&value, sizeof(value));
+    if (ret)
+    {
+        win_skip("UDP_SEND_MSG_SIZE is not supported, error %u.\n", WSAGetLastError());
+        closesocket(client);
+        closesocket(server);
+        return;
+    }
+
+    value = 0xdeadbeef;
+    len = sizeof(value);
+    ret = getsockopt(client, IPPROTO_UDP, UDP_SEND_MSG_SIZE, (char *)&value, &len);
+    ok(!ret, "got error %u.\n", WSAGetLastError());
+    ok(value == 100, "got %lu.\n", value);
+    ok(len == sizeof(value), "got len %d.\n", len);
+
+    ret = bind(server, (const struct sockaddr *)&bind_addr, sizeof(bind_addr));
+    ok(!ret, "got error %u.\n", WSAGetLastError());
+    len = sizeof(addr);
+    ret = getsockname(server, (struct sockaddr *)&addr, &len);
+    ok(!ret, "got error %u.\n", WSAGetLastError());
+
+    for (i = 0; i < sizeof(buffer); ++i) buffer[i] = i;
+    ret = sendto(client, buffer, sizeof(buffer), 0, (struct sockaddr *)&addr, sizeof(addr));
+    ok(ret == sizeof(buffer), "got %d, error %u.\n", ret, WSAGetLastError());
+
+    /* the data is split into datagrams of the requested size */
+    for (i = 0; i < 3; ++i)
+    {
+        ret = recv(server, recv_buffer, sizeof(recv_buffer), 0);
+        ok(ret == 100, "got %d, error %u.\n", ret, WSAGetLastError());
+        ok(!memcmp(recv_buffer, buffer + i * 100, 100), "got wrong data for datagram %d.\n", i);
+    }
+
+    value = 0xdeadbeef;
+    len = sizeof(value);
+    ret = getsockopt(server, IPPROTO_UDP, UDP_RECV_MAX_COALESCED_SIZE, (char *)&value, &len);
+    ok(!ret, "got error %u.\n", WSAGetLastError());
+    ok(!value, "got %lu.\n", value);
+    ok(len == sizeof(value), "got len %d.\n", len);
+
+    value = 65535;
+    ret = setsockopt(server, IPPROTO_UDP, UDP_RECV_MAX_COALESCED_SIZE, (char *)&value, sizeof(value));
+    ok(!ret, "got error %u.\n", WSAGetLastError());
+
+    value = 0xdeadbeef;
+    len = sizeof(value);
+    ret = getsockopt(server, IPPROTO_UDP, UDP_RECV_MAX_COALESCED_SIZE, (char *)&value, &len);
+    ok(!ret, "got error %u.\n", WSAGetLastError());
+    ok(value == 65535, "got %lu.\n", value);
+    ok(len == sizeof(value), "got len %d.\n", len);
+
+    closesocket(client);
+    closesocket(server);
+}
+
 /* Regression test for an internal bug affecting wget.exe. */
 static void test_select_after_WSAEventSelect(void)
 {
@@ -14763,6 +14832,174 @@ static void test_valid_handle(void)
     ok(!ret, "closesocket failed unexpectedly: %d\n", ret);
 }
 
+static void test_rio(void)
+{
+    static const GUID rio_guid = WSAID_MULTIPLE_RIO;
+    RIO_NOTIFICATION_COMPLETION notify = {0};
+    RIO_EXTENSION_FUNCTION_TABLE rio = {0};
+    char send_data[16] = "registered", recv_data[16];
+    RIO_BUFFERID send_id, recv_id;
+    RIO_BUF send_buf, recv_buf;
+    RIORESULT results[4];
+    RIO_CQ send_cq, recv_cq;
+    SOCKET client, server;
+    OVERLAPPED overlapped = {0}, *povl;
+    DWORD size, flags = 0;
+    RIO_RQ rq, rq2;
+    HANDLE event, port;
+    ULONG_PTR key;
+    WSABUF wsabuf;
+    ULONG count;
+    int i, ret;
+
+    tcp_socketpair_flags(&client, &server, WSA_FLAG_OVERLAPPED | WSA_FLAG_REGISTERED_IO);
+
+    ret = WSAIoctl(client, SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER, (void *)&rio_guid, sizeof(rio_guid),
+                   &rio, sizeof(rio), &size, NULL, NULL);
+    if (ret)
+    {
+        win_skip("RIO is not supported.\n");
+        closesocket(client);
+        closesocket(server);
+        return;
+    }
+    ok(size == sizeof(rio), "got size %lu.\n", size);
+    ok(rio.cbSize == sizeof(rio), "got cbSize %lu.\n", rio.cbSize);
+
+    event = CreateEventW(NULL, FALSE, FALSE, NULL);
+    notify.Type = RIO_EVENT_COMPLETION;
+    notify.Event.EventHandle = event;
+    notify.Event.NotifyReset = TRUE;
+
+    send_cq = rio.RIOCreateCompletionQueue(4, NULL);
+    ok(send_cq != RIO_INVALID_CQ, "got error %u.\n", WSAGetLastError());
+    recv_cq = rio.RIOCreateCompletionQueue(4, &notify);
+    ok(recv_cq != RIO_INVALID_CQ, "got error %u.\n", WSAGetLastError());
+
+    /* the application can still use its own completion port for regular overlapped I/O */
+    port = CreateIoCompletionPort((HANDLE)server, NULL, 0x1111, 0);
+    ok(!!port, "got error %lu.\n", GetLastError());
+
+    rq = rio.RIOCreateRequestQueue(server, 1, 1, 1, 1, recv_cq, send_cq, (void *)0xdead);
+    ok(rq != RIO_INVALID_RQ, "got error %u.\n", WSAGetLastError());
+    rq2 = rio.RIOCreateRequestQueue(client, 1, 1, 1, 1, recv_cq, send_cq, (void *)0xbeef);
+    ok(rq2 != RIO_INVALID_RQ, "got error %u.\n", WSAGetLastError());
+
+    send_id = rio.RIORegisterBuffer(send_data, sizeof(send_data));
+    ok(send_id != RIO_INVALID_BUFFERID, "got error %u.\n", WSAGetLastError());
+    recv_id = rio.RIORegisterBuffer(recv_data, sizeof(recv_data));
+    ok(recv_id != RIO_INVALID_BUFFERID, "got error %u.\n", WSAGetLastError());
+
+    count = rio.RIODequeueCompletion(recv_cq, results, ARRAY_SIZE(results));
+    ok(!count, "got count %lu.\n", count);
+
+    ret = rio.RIONotify(recv_cq);
+    ok(!ret, "got %d.\n", ret);
+    ret = rio.RIONotify(recv_cq);
+    ok(ret == WSAEALREADY, "got %d.\n", ret);
+
+    recv_buf.BufferId = recv_id;
+    recv_buf.Offset = 0;
+    recv_buf.Length = sizeof(recv_data);
+    ret = rio.RIOReceive(rq, &recv_buf, 1, 0, (void *)0x1234);
+    ok(ret, "got error %u.\n", WSAGetLastError());
+    ret = rio.RIOReceive(rq, &recv_buf, 1, 0, (void *)0x1234);
+    ok(!ret, "expected failure.\n");
+    ok(WSAGetLastError() == WSAENOBUFS, "got error %u.\n", WSAGetLastError());
+
+    send_buf.BufferId = send_id;
+    send_buf.Offset = 0;
+    send_buf.Length = 32;
+    ret = rio.RIOSend(rq2, &send_buf, 1, 0, (void *)0x5678);
+    ok(!ret, "expected failure.\n");
+    ok(WSAGetLastError() == WSAEINVAL, "got error %u.\n", WSAGetLastError());
+
+    send_buf.Length = 10;
+    ret = rio.RIOSend(rq2, &send_buf, 1, 0, (void *)0x5678);
+    ok(ret, "got error %u.\n", WSAGetLastError());
+
+    size = WaitForSingleObject(event, 1000);
+    ok(!size, "got %lu.\n", size);
+
+    memset(results, 0xcc, sizeof(results));
+    count = rio.RIODequeueCompletion(recv_cq, results, ARRAY_SIZE(results));
+    ok(count == 1, "got count %lu.\n", count);
+    ok(!results[0].Status, "got status %ld.\n", results[0].Status);
+    ok(results[0].BytesTransferred == 10, "got size %lu.\n", results[0].BytesTransferred);
+    ok(results[0].SocketContext == 0xdead, "got socket context %#I64x.\n", results[0].SocketContext);
+    ok(results[0].RequestContext == 0x1234, "got request context %#I64x.\n", results[0].RequestContext);
+    ok(!memcmp(recv_data, "registered", 10), "got %s.\n", debugstr_an(recv_data, 10));
+
+    for (i = 0; i < 100; i++)
+    {
+        if ((count = rio.RIODequeueCompletion(send_cq, results, ARRAY_SIZE(results)))) break;
+        Sleep(10);
+    }
+    ok(count == 1, "got count %lu.\n", count);
+    ok(!results[0].Status, "got status %ld.\n", results[0].Status);
+    ok(results[0].BytesTransferred == 10, "got size %lu.\n", results[0].BytesTransferred);
+    ok(results[0].SocketContext == 0xbeef, "got socket context %#I64x.\n", results[0].SocketContext);
+    ok(results[0].RequestContext == 0x5678, "got request context %#I64x.\n", results[0].RequestContext);
+
+    /* the request slots are reused once the results are dequeued */
+    ret = rio.RIOReceive(rq, &recv_buf, 1, RIO_MSG_DONT_NOTIFY, (void *)0x4321);
+    ok(ret, "got error %u.\n", WSAGetLastError());
+    ret = rio.RIOSend(rq2, &send_buf, 1, 0, (void *)0x8765);
+    ok(ret, "got error %u.\n", WSAGetLastError());
+
+    for (i = 0, count = 0; i < 100; i++)
+    {
+        if ((count = rio.RIODequeueCompletion(recv_cq, results, ARRAY_SIZE(results)))) break;
+        Sleep(10);
+    }
+    ok(count == 1, "got count %lu.\n", count);
+    ok(!results[0].Status, "got status %ld.\n", results[0].Status);
+    ok(results[0].BytesTransferred == 10, "got size %lu.\n", results[0].BytesTransferred);
+    ok(results[0].RequestContext == 0x4321, "got request context %#I64x.\n", results[0].RequestContext);
+
+    for (i = 0, count = 0; i < 100; i++)
+    {
+        if ((count = rio.RIODequeueCompletion(send_cq, results, ARRAY_SIZE(results)))) break;
+        Sleep(10);
+    }
+    ok(count == 1, "got count %lu.\n", count);
+    ok(results[0].RequestContext == 0x8765, "got request context %#I64x.\n", results[0].RequestContext);
+
+    /* RIO completions are not posted to the completion port of the socket */
+    ret = GetQueuedCompletionStatus(port, &size, &key, &povl, 0);
+    ok(!ret, "expected failure.\n");
+    ok(GetLastError() == WAIT_TIMEOUT, "got error %lu.\n", GetLastError());
+
+    wsabuf.buf = recv_data;
+    wsabuf.len = sizeof(recv_data);
+    memset(recv_data, 0, sizeof(recv_data));
+    ret = WSARecv(server, &wsabuf, 1, NULL, &flags, &overlapped, NULL);
+    ok(ret == -1, "got %d.\n", ret);
+    ok(WSAGetLastError() == ERROR_IO_PENDING, "got error %u.\n", WSAGetLastError());
+
+    ret = send(client, "overlapped", 10, 0);
+    ok(ret == 10, "got %d.\n", ret);
+
+    ret = GetQueuedCompletionStatus(port, &size, &key, &povl, 1000);
+    ok(ret, "got error %lu.\n", GetLastError());
+    ok(size == 10, "got size %lu.\n", size);
+    ok(key == 0x1111, "got key %#Ix.\n", key);
+    ok(povl == &overlapped, "got overlapped %p.\n", povl);
+    ok(!memcmp(recv_data, "overlapped", 10), "got %s.\n", debugstr_an(recv_data, 10));
+
+    count = rio.RIODequeueCompletion(recv_cq, results, ARRAY_SIZE(results));
+    ok(!count, "got count %lu.\n", count);
+
+    rio.RIODeregisterBuffer(send_id);
+    rio.RIODeregisterBuffer(recv_id);
+    closesocket(client);
+    closesocket(server);
+    rio.RIOCloseCompletionQueue(send_cq);
+    rio.RIOCloseCompletionQueue(recv_cq);
+    CloseHandle(event);
+    CloseHandle(port);
+}
+
 static void test_afunix_path( const char *path )
 {
     SOCKET listener, client, server = 0;
@@ -15127,10 +15364,12 @@ START_TEST( sock )
     test_icmpv6();
     test_connect_udp();
     test_tcp_sendto_recvfrom();
+    test_udp_send_offload();
     test_broadcast();
     test_send_buffering();
     test_valid_handle();
     test_afunix();
+    test_rio();
 
     /* There is apparently an obscure interaction between this test and
      * test_WSAGetOverlappedResult().
@@ -885,6 +885,15 @@ struct cursor_pos
     lparam_t info;
 };
 
+struct completion_msg
+{
+    apc_param_t   ckey;
+    apc_param_t   cvalue;
+    apc_param_t   information;
+    unsigned int  status;
+    int           __pad;
+};
+
 struct directory_entry
 {
     data_size_t name_len;
@@ -5589,6 +5598,7 @@ struct remove_completion_reply
     apc_param_t   information;
     unsigned int  status;
     obj_handle_t  wait_handle;
+    /* VARARG(msgs,completion_msgs); */
 };
 
 
@@ -7177,6 +7187,6 @@ union generic_reply
     struct alpc_create_port_reply alpc_create_port_reply;
 };
 
-#define SERVER_PROTOCOL_VERSION 957
+#define SERVER_PROTOCOL_VERSION 958
 
 #endif /* __WINE_WINE_SERVER_PROTOCOL_H */
@@ -1050,6 +1050,9 @@ NTSYSAPI WORD         WINAPI RtlQueryDepthSList(PSLIST_HEADER);
 
 typedef enum _HEAP_INFORMATION_CLASS {
     HeapCompatibilityInformation,
+#ifdef __WINESRC__
+    HeapWineStatisticsInformation = 1000,
+#endif
 } HEAP_INFORMATION_CLASS;
 
 /* Processor feature flags.  */
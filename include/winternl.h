@@ -2840,6 +2840,37 @@ typedef struct _RTL_HEAP_PARAMETERS
     SIZE_T Reserved[2];
 } RTL_HEAP_PARAMETERS, *PRTL_HEAP_PARAMETERS;
 
+#ifdef __WINESRC__
+/* data for HeapWineStatisticsInformation */
+typedef struct
+{
+    SIZE_T    BlockSize;
+    ULONG     AllocCount;         /* allocations from the free lists */
+    ULONG     FreeCount;          /* frees to the free lists */
+    ULONG     LfhAllocCount;      /* allocations from the LFH, only counted when enabled */
+    ULONG     LfhFreeCount;       /* frees to the LFH, only counted when enabled */
+    BOOLEAN   LfhEnabled;
+} WINE_HEAP_BIN_STATISTICS;
+
+typedef struct
+{
+    ULONG     Size;               /* size of the returned data */
+    BOOLEAN   Enabled;            /* whether the optional counters are maintained */
+    SIZE_T    CommittedSize;
+    SIZE_T    UsedSize;
+    SIZE_T    FreeSize;
+    SIZE_T    LargeSize;
+    ULONG     SubheapCount;
+    ULONG     LargeCount;
+    ULONG     CommitCount;
+    ULONG     DecommitCount;
+    ULONG     LockContentionCount;
+    ULONGLONG LockWaitTime;       /* in 100ns units */
+    ULONG     BinCount;
+    WINE_HEAP_BIN_STATISTICS Bins[ANYSIZE_ARRAY];
+} WINE_HEAP_STATISTICS_INFORMATION;
+#endif
+
 typedef struct _RTL_RWLOCK {
     RTL_CRITICAL_SECTION rtlCS;
 
@@ -299,6 +299,20 @@ typedef struct WS(in6_pktinfo) {
 #define WS_TCP_OFFLOAD_PREFERRED        2
 #endif /* USE_WS_PREFIX */
 
+#ifndef USE_WS_PREFIX
+#define UDP_NOCHECKSUM                  1
+#define UDP_SEND_MSG_SIZE               2
+#define UDP_RECV_MAX_COALESCED_SIZE     3
+#define UDP_COALESCED_INFO              3
+#define UDP_CHECKSUM_COVERAGE           20
+#else
+#define WS_UDP_NOCHECKSUM               1
+#define WS_UDP_SEND_MSG_SIZE            2
+#define WS_UDP_RECV_MAX_COALESCED_SIZE  3
+#define WS_UDP_COALESCED_INFO           3
+#define WS_UDP_CHECKSUM_COVERAGE        20
+#endif /* USE_WS_PREFIX */
+
 #ifndef USE_WS_PREFIX
 /* TCP_NODELAY is defined elsewhere */
 #define TCP_EXPEDITED_1122              2
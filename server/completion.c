@@ -377,6 +377,9 @@ DECL_HANDLER(remove_completion)
     }
     else
     {
+        struct completion_msg *msgs;
+        data_size_t i, count;
+
         list_remove( entry );
         completion->depth--;
         msg = LIST_ENTRY( entry, struct comp_msg, queue_entry );
@@ -386,6 +389,25 @@ DECL_HANDLER(remove_completion)
         reply->information = msg->information;
         free( msg );
         reply->wait_handle = 0;
+
+        /* return as many of the remaining completions as the client asked for */
+        count = min( get_reply_max_size() / sizeof(*msgs), completion->depth );
+        if (count && (msgs = set_reply_data_size( count * sizeof(*msgs) )))
+        {
+            for (i = 0; i < count; i++)
+            {
+                entry = list_head( &completion->queue );
+                list_remove( entry );
+                completion->depth--;
+                msg = LIST_ENTRY( entry, struct comp_msg, queue_entry );
+                msgs[i].ckey = msg->ckey;
+                msgs[i].cvalue = msg->cvalue;
+                msgs[i].information = msg->information;
+                msgs[i].status = msg->status;
+                msgs[i].__pad = 0;
+                free( msg );
+            }
+        }
         if (list_empty( &completion->queue )) reset_sync( completion->sync );
     }
 
@@ -166,8 +166,25 @@ struct addr_range
         client_ptr_t base;
         mem_size_t size;
     } *free;
+    mem_size_t builtin_size;   /* size reserved for builtin images */
+    mem_size_t builtin_limit;  /* maximum size that can be reserved for builtin images */
 };
 
+/* address assigned to a builtin image, kept for the lifetime of the server so that
+ * all the processes map it at the same base and share its relocated pages */
+struct builtin_map_addr
+{
+    struct list  entry;
+    dev_t        dev;
+    ino_t        ino;
+    off_t        file_size;
+    time_t       mtime;
+    client_ptr_t base;
+    mem_size_t   size;
+};
+
+static struct list builtin_map_addrs = LIST_INIT( builtin_map_addrs );
+
 static size_t host_page_mask;
 static const size_t page_mask = 0xfff;
 static const size_t granularity_mask = 0xffff;
@@ -216,6 +233,8 @@ void init_memory(void)
     host_page_mask = sysconf( _SC_PAGESIZE ) - 1;
     free_map_addr( 0x60000000, 0x1c000000 );
     free_map_addr( 0x600000000000, 0x100000000000 );
+    ranges32.builtin_limit = 0x1c000000 / 2;
+    ranges64.builtin_limit = 0x100000000000 / 2;
 }
 
 static void ranges_dump( struct object *obj, int verbose )
@@ -1291,10 +1310,66 @@ static enum server_fd_type mapping_get_fd_type( struct fd *fd )
     return FD_TYPE_FILE;
 }
 
+/* allocate an address range for a PE image mapping */
+static client_ptr_t alloc_map_addr( struct addr_range *range, mem_size_t size )
+{
+    unsigned int i;
+
+    for (i = 0; i < range->count; i++)
+    {
+        if (range->free[i].size < size) continue;
+        range->free[i].size -= size;
+        return range->free[i].base + range->free[i].size;
+    }
+    return 0;
+}
+
+/* assign a permanent mapping address to a builtin image */
+static client_ptr_t assign_builtin_map_address( struct mapping *mapping, struct addr_range *range,
+                                                mem_size_t size )
+{
+    struct builtin_map_addr *addr;
+    struct stat st;
+    client_ptr_t ret;
+    int unix_fd;
+
+    if ((unix_fd = get_unix_fd( mapping->fd )) == -1 || fstat( unix_fd, &st ) == -1)
+    {
+        clear_error();
+        return 0;
+    }
+
+    LIST_FOR_EACH_ENTRY( addr, &builtin_map_addrs, struct builtin_map_addr, entry )
+    {
+        if (addr->dev != st.st_dev || addr->ino != st.st_ino) continue;
+        if (addr->file_size != st.st_size || addr->mtime != st.st_mtime || addr->size < size) return 0;
+        set_fd_map_address( mapping->fd, addr->base, 0 );
+        return addr->base;
+    }
+
+    if (range->builtin_size + size > range->builtin_limit) return 0;
+    if (!(addr = mem_alloc( sizeof(*addr) ))) return 0;
+    if (!(ret = alloc_map_addr( range, size )))
+    {
+        free( addr );
+        return 0;
+    }
+    addr->dev       = st.st_dev;
+    addr->ino       = st.st_ino;
+    addr->file_size = st.st_size;
+    addr->mtime     = st.st_mtime;
+    addr->base      = ret;
+    addr->size      = size;
+    list_add_tail( &builtin_map_addrs, &addr->entry );
+    range->builtin_size += size;
+    /* the range is never freed, so don't let the fd release it */
+    set_fd_map_address( mapping->fd, ret, 0 );
+    return ret;
+}
+
 /* assign a mapping address to a PE image mapping */
 static client_ptr_t assign_map_address( struct mapping *mapping )
 {
-    unsigned int i;
     client_ptr_t ret;
     struct addr_range *range = (mapping->image.base >> 32) ? &ranges64 : &ranges32;
     mem_size_t size = round_size( mapping->size, granularity_mask );
@@ -1305,15 +1380,11 @@ static client_ptr_t assign_map_address( struct mapping *mapping )
 
     size += granularity_mask + 1;  /* leave some free space between mappings */
 
-    for (i = 0; i < range->count; i++)
-    {
-        if (range->free[i].size < size) continue;
-        range->free[i].size -= size;
-        ret = range->free[i].base + range->free[i].size;
-        set_fd_map_address( mapping->fd, ret, size );
+    if (mapping->image.wine_builtin && (ret = assign_builtin_map_address( mapping, range, size )))
         return ret;
-    }
-    return 0;
+
+    if ((ret = alloc_map_addr( range, size ))) set_fd_map_address( mapping->fd, ret, size );
+    return ret;
 }
 
 /* free a PE mapping address range when the last mapping is closed */
@@ -890,7 +890,7 @@ static void message_queue_read( struct pipe_end *pipe_end, struct async *async )
     }
 
     message = LIST_ENTRY( list_head(&pipe_end->message_queue), struct pipe_message, entry );
-    if (!message->read_pos && message->iosb->in_size == iosb->out_size) /* fast path */
+    if (!message->read_pos && message->iosb->in_size == out_size) /* fast path, pass the whole message */
     {
         async_request_complete( async, status, out_size, out_size, message->iosb->in_data );
         message->iosb->in_data = NULL;
@@ -85,11 +85,15 @@ struct key
     data_size_t       classlen;    /* length of class name */
     int               last_subkey; /* last in use subkey */
     int               nb_subkeys;  /* count of allocated subkeys */
+    int               sorted_subkeys; /* count of sorted subkeys at the start of the array */
     struct key      **subkeys;     /* subkeys array */
+    struct key_index *subkey_index; /* hash index of the subkey names */
     struct key       *wow6432node; /* Wow6432Node subkey */
     int               last_value;  /* last in use value */
     int               nb_values;   /* count of allocated values in array */
+    int               sorted_values; /* count of sorted values at the start of the array */
     struct key_value *values;      /* values array */
+    struct key_index *value_index; /* hash index of the value names */
     unsigned int      flags;       /* flags */
     timeout_t         modif;       /* last modification time */
     struct list       notify_list; /* list of notifications */
@@ -117,6 +121,21 @@ struct key_value
 
 #define MIN_SUBKEYS  8   /* min. number of allocated subkeys per key */
 #define MIN_VALUES   8   /* min. number of allocated values per key */
+#define MIN_INDEXED  32  /* min. number of subkeys or values to use a hash index */
+
+/* hash index of the subkey or value names of a key
+ *
+ * Keys with many entries append new subkeys and values at the end of the arrays instead of
+ * inserting them in order, and use the index for lookups. The unsorted entries are sorted
+ * when the order matters, i.e. for enumeration and saving.
+ */
+struct key_index
+{
+    unsigned int size;      /* number of slots, a power of 2 */
+    int          slots[1];  /* positions in the subkeys or values array, -1 if free */
+};
+
+typedef struct unicode_str (*get_entry_name_func)( const struct key *key, int pos );
 
 #define MAX_NAME_LEN  256    /* max. length of a key name */
 #define MAX_VALUE_LEN 16383  /* max. length of a value name */
@@ -135,6 +154,7 @@ static const struct unicode_str symlink_str = { symlink_value, sizeof(symlink_va
 
 static void set_periodic_save_timer(void);
 static struct key_value *find_value( const struct key *key, struct unicode_str name, int *index );
+static void sort_values( struct key *key );
 
 /* information about where to save a registry branch */
 struct save_branch_info
@@ -279,20 +299,143 @@ static void dump_value( const struct key_value *value, FILE *f )
     fputc( '\n', f );
 }
 
+/* compare two subkey or value names */
+static int compare_names( struct unicode_str name1, struct unicode_str name2 )
+{
+    int res = memicmp_strW( name1.str, name2.str, min( name1.len, name2.len ));
+    if (!res) res = name1.len - name2.len;
+    return res;
+}
+
+static struct unicode_str get_subkey_name( const struct key *key, int pos )
+{
+    struct unicode_str name;
+    name.str = key->subkeys[pos]->obj.name->name;
+    name.len = key->subkeys[pos]->obj.name->len;
+    return name;
+}
+
+static struct unicode_str get_value_name( const struct key *key, int pos )
+{
+    struct unicode_str name;
+    name.str = key->values[pos].name;
+    name.len = key->values[pos].namelen;
+    return name;
+}
+
+/* add the entry at the specified position to a hash index */
+static void key_index_add( const struct key *key, struct key_index *index,
+                           get_entry_name_func get_name, int pos )
+{
+    struct unicode_str name = get_name( key, pos );
+    unsigned int i = hash_strW( name.str, name.len, index->size );
+
+    while (index->slots[i] != -1) i = (i + 1) & (index->size - 1);
+    index->slots[i] = pos;
+}
+
+/* remove the entry at the specified position from a hash index */
+static void key_index_remove( const struct key *key, struct key_index *index,
+                              get_entry_name_func get_name, int pos )
+{
+    struct unicode_str name = get_name( key, pos );
+    unsigned int i, j, hash, mask = index->size - 1;
+
+    for (i = hash_strW( name.str, name.len, index->size ); index->slots[i] != pos; i = (i + 1) & mask) ;
+
+    /* move back the following entries that can no longer be reached */
+    for (j = (i + 1) & mask; index->slots[j] != -1; j = (j + 1) & mask)
+    {
+        name = get_name( key, index->slots[j] );
+        hash = hash_strW( name.str, name.len, index->size );
+        if (((j - hash) & mask) < ((j - i) & mask)) continue;
+        index->slots[i] = index->slots[j];
+        i = j;
+    }
+    index->slots[i] = -1;
+}
+
+/* find a name in a hash index and return its position */
+static int key_index_find( const struct key *key, const struct key_index *index,
+                           get_entry_name_func get_name, struct unicode_str name )
+{
+    unsigned int i = hash_strW( name.str, name.len, index->size );
+
+    for ( ; index->slots[i] != -1; i = (i + 1) & (index->size - 1))
+        if (!compare_names( get_name( key, index->slots[i] ), name )) return index->slots[i];
+    return -1;
+}
+
+/* build the hash index of an array, or free it if the array is small enough */
+static void rebuild_key_index( const struct key *key, struct key_index **index,
+                               get_entry_name_func get_name, int count )
+{
+    unsigned int size = 64;
+    int pos;
+
+    free( *index );
+    *index = NULL;
+    if (count < MIN_INDEXED) return;
+
+    while (size < 2 * count) size *= 2;
+    if (!(*index = malloc( offsetof( struct key_index, slots[size] )))) return;
+    (*index)->size = size;
+    memset( (*index)->slots, 0xff, size * sizeof((*index)->slots[0]) );
+    for (pos = 0; pos < count; pos++) key_index_add( key, *index, get_name, pos );
+}
+
+/* update the sorted count and the index of an array after inserting an entry */
+static void entry_inserted( const struct key *key, int *sorted, struct key_index **index,
+                            get_entry_name_func get_name, int pos, int count )
+{
+    /* entries are only inserted in the middle when all of them are sorted */
+    if (*sorted == count - 1 &&
+        (pos < count - 1 || !pos || compare_names( get_name( key, pos - 1 ), get_name( key, pos )) < 0))
+        (*sorted)++;
+
+    if (*index && pos == count - 1 && count * 2 <= (*index)->size)
+        key_index_add( key, *index, get_name, pos );
+    else if (*index || count >= MIN_INDEXED)
+        rebuild_key_index( key, index, get_name, count );
+}
+
+/* update the sorted count and the index of an array before removing an entry */
+static void entry_removing( const struct key *key, int *sorted, struct key_index **index,
+                            get_entry_name_func get_name, int pos, int count )
+{
+    if (pos < *sorted) (*sorted)--;
+    if (!*index) return;
+    if (pos == count - 1) key_index_remove( key, *index, get_name, pos );
+    else
+    {
+        /* the following entries will move, the index needs to be rebuilt */
+        free( *index );
+        *index = NULL;
+    }
+}
+
 /* find the named child of a given key and return its index */
 static struct key *find_subkey( const struct key *key, struct unicode_str name, int *index )
 {
     int i, min, max, res;
-    data_size_t len;
+
+    if (key->subkey_index)
+    {
+        if ((i = key_index_find( key, key->subkey_index, get_subkey_name, name )) == -1)
+        {
+            *index = key->last_subkey + 1;  /* append it at the end */
+            return NULL;
+        }
+        *index = i;
+        return key->subkeys[i];
+    }
 
     min = 0;
-    max = key->last_subkey;
+    max = key->sorted_subkeys - 1;
     while (min <= max)
     {
         i = (min + max) / 2;
-        len = min( key->subkeys[i]->obj.name->len, name.len );
-        res = memicmp_strW( key->subkeys[i]->obj.name->name, name.str, len );
-        if (!res) res = key->subkeys[i]->obj.name->len - name.len;
+        res = compare_names( get_subkey_name( key, i ), name );
         if (!res)
         {
             *index = i;
@@ -302,9 +445,56 @@ static struct key *find_subkey( const struct key *key, struct unicode_str name,
         else min = i + 1;
     }
     *index = min;  /* this is where we should insert it */
+
+    for (i = key->sorted_subkeys; i <= key->last_subkey; i++)
+    {
+        if (compare_names( get_subkey_name( key, i ), name )) continue;
+        *index = i;
+        return key->subkeys[i];
+    }
+    if (key->sorted_subkeys <= key->last_subkey) *index = key->last_subkey + 1;
     return NULL;
 }
 
+static int compare_subkeys( const void *ptr1, const void *ptr2 )
+{
+    const struct key *key1 = *(const struct key * const *)ptr1;
+    const struct key *key2 = *(const struct key * const *)ptr2;
+    data_size_t len = min( key1->obj.name->len, key2->obj.name->len );
+    int res = memicmp_strW( key1->obj.name->name, key2->obj.name->name, len );
+
+    if (!res) res = key1->obj.name->len - key2->obj.name->len;
+    return res;
+}
+
+/* sort the subkeys that were appended at the end of the array */
+static void sort_subkeys( struct key *key )
+{
+    int i, j, k, count = key->last_subkey + 1, sorted = key->sorted_subkeys;
+    struct key **tail;
+
+    if (sorted == count) return;
+
+    qsort( key->subkeys + sorted, count - sorted, sizeof(*key->subkeys), compare_subkeys );
+    if (sorted && (tail = malloc( (count - sorted) * sizeof(*tail) )))
+    {
+        /* merge them with the sorted ones, starting from the end */
+        memcpy( tail, key->subkeys + sorted, (count - sorted) * sizeof(*tail) );
+        for (i = sorted - 1, j = count - sorted - 1, k = count - 1; j >= 0; k--)
+        {
+            if (i >= 0 && compare_subkeys( &key->subkeys[i], &tail[j] ) > 0)
+                key->subkeys[k] = key->subkeys[i--];
+            else
+                key->subkeys[k] = tail[j--];
+        }
+        free( tail );
+    }
+    else if (sorted) qsort( key->subkeys, count, sizeof(*key->subkeys), compare_subkeys );
+
+    key->sorted_subkeys = count;
+    if (key->subkey_index) rebuild_key_index( key, &key->subkey_index, get_subkey_name, count );
+}
+
 /* try to grow the array of subkeys; return 1 if OK, 0 on error */
 static int grow_subkeys( struct key *key )
 {
@@ -331,11 +521,13 @@ static int grow_subkeys( struct key *key )
 }
 
 /* save a registry and all its subkeys to a text file */
-static void save_subkeys( const struct key *key, const struct key *base, FILE *f )
+static void save_subkeys( struct key *key, const struct key *base, FILE *f )
 {
     int i;
 
     if (key->flags & KEY_VOLATILE) return;
+    sort_subkeys( key );
+    sort_values( key );
     /* save key if it has either some values or no subkeys, or needs special options */
     /* keys with no values but subkeys are saved implicitly by saving the subkeys */
     if ((key->last_value >= 0) || (key->last_subkey == -1) || key->class || (key->flags & KEY_SYMLINK))
@@ -598,6 +790,8 @@ static int key_link_name( struct object *obj, struct object_name *name, struct o
     for (i = ++parent_key->last_subkey; i > index; i--)
         parent_key->subkeys[i] = parent_key->subkeys[i - 1];
     parent_key->subkeys[index] = (struct key *)grab_object( key );
+    entry_inserted( parent_key, &parent_key->sorted_subkeys, &parent_key->subkey_index,
+                    get_subkey_name, index, parent_key->last_subkey + 1 );
     if (is_wow6432node( name->name, name->len ) &&
         !is_wow6432node( parent_key->obj.name->name, parent_key->obj.name->len ))
         parent_key->wow6432node = key;
@@ -619,10 +813,15 @@ static void key_unlink_name( struct object *obj, struct object_name *name )
         return;
     }
 
-    for (i = 0; i <= parent->last_subkey; i++) if (parent->subkeys[i] == key) break;
-    assert( i <= parent->last_subkey );
+    /* subkeys are usually deleted starting from the last one */
+    for (i = parent->last_subkey; i >= 0; i--) if (parent->subkeys[i] == key) break;
+    assert( i >= 0 );
+    entry_removing( parent, &parent->sorted_subkeys, &parent->subkey_index,
+                    get_subkey_name, i, parent->last_subkey + 1 );
     for ( ; i < parent->last_subkey; i++) parent->subkeys[i] = parent->subkeys[i + 1];
     parent->last_subkey--;
+    if (!parent->subkey_index)
+        rebuild_key_index( parent, &parent->subkey_index, get_subkey_name, parent->last_subkey + 1 );
     name->parent = NULL;
     if (parent->wow6432node == key) parent->wow6432node = NULL;
     release_object( key );
@@ -663,12 +862,14 @@ static void key_destroy( struct object *obj )
         free( key->values[i].data );
     }
     free( key->values );
+    free( key->value_index );
     for (i = 0; i <= key->last_subkey; i++)
     {
         key->subkeys[i]->obj.name->parent = NULL;
         release_object( key->subkeys[i] );
     }
     free( key->subkeys );
+    free( key->subkey_index );
     /* unconditionally notify everything waiting on this key */
     while ((ptr = list_head( &key->notify_list )))
     {
@@ -696,11 +897,15 @@ static struct key *create_key_object( struct object *parent, struct unicode_str
             key->flags       = 0;
             key->last_subkey = -1;
             key->nb_subkeys  = 0;
+            key->sorted_subkeys = 0;
             key->subkeys     = NULL;
+            key->subkey_index = NULL;
             key->wow6432node = NULL;
             key->nb_values   = 0;
             key->last_value  = -1;
+            key->sorted_values = 0;
             key->values      = NULL;
+            key->value_index = NULL;
             key->modif       = modif;
             list_init( &key->notify_list );
 
@@ -914,6 +1119,7 @@ static void enum_key( struct key *key, int index, int info_class, struct enum_ke
             set_error( STATUS_NO_MORE_ENTRIES );
             return;
         }
+        sort_subkeys( key );
         key = key->subkeys[index];
     }
 
@@ -1028,20 +1234,23 @@ static void rename_key( struct key *key, struct unicode_str new_name )
     for (cur_index = 0; cur_index <= parent->last_subkey; cur_index++)
         if (parent->subkeys[cur_index] == key) break;
 
-    if (cur_index < index)
-    {
-        --index;
-        for (i = cur_index; i < index; ++i) parent->subkeys[i] = parent->subkeys[i+1];
-    }
-    else if (cur_index > index)
-    {
-        for (i = cur_index; i > index; --i) parent->subkeys[i] = parent->subkeys[i-1];
-    }
-    parent->subkeys[index] = key;
+    /* remove the key from the array and insert it back with its new name */
+    entry_removing( parent, &parent->sorted_subkeys, &parent->subkey_index,
+                    get_subkey_name, cur_index, parent->last_subkey + 1 );
+    for (i = cur_index; i < parent->last_subkey; i++) parent->subkeys[i] = parent->subkeys[i + 1];
+    parent->last_subkey--;
 
     free( key->obj.name );
     key->obj.name = new_name_ptr;
 
+    if (!parent->subkey_index)
+        rebuild_key_index( parent, &parent->subkey_index, get_subkey_name, parent->last_subkey + 1 );
+    find_subkey( parent, new_name, &index );
+    for (i = ++parent->last_subkey; i > index; i--) parent->subkeys[i] = parent->subkeys[i - 1];
+    parent->subkeys[index] = key;
+    entry_inserted( parent, &parent->sorted_subkeys, &parent->subkey_index,
+                    get_subkey_name, index, parent->last_subkey + 1 );
+
     if (debug_level > 1) dump_operation( key, NULL, "Rename" );
     touch_key( key, REG_NOTIFY_CHANGE_NAME );
 }
@@ -1111,16 +1320,24 @@ static int grow_values( struct key *key )
 static struct key_value *find_value( const struct key *key, struct unicode_str name, int *index )
 {
     int i, min, max, res;
-    data_size_t len;
+
+    if (key->value_index)
+    {
+        if ((i = key_index_find( key, key->value_index, get_value_name, name )) == -1)
+        {
+            *index = key->last_value + 1;  /* append it at the end */
+            return NULL;
+        }
+        *index = i;
+        return &key->values[i];
+    }
 
     min = 0;
-    max = key->last_value;
+    max = key->sorted_values - 1;
     while (min <= max)
     {
         i = (min + max) / 2;
-        len = min( key->values[i].namelen, name.len );
-        res = memicmp_strW( key->values[i].name, name.str, len );
-        if (!res) res = key->values[i].namelen - name.len;
+        res = compare_names( get_value_name( key, i ), name );
         if (!res)
         {
             *index = i;
@@ -1130,9 +1347,55 @@ static struct key_value *find_value( const struct key *key, struct unicode_str n
         else min = i + 1;
     }
     *index = min;  /* this is where we should insert it */
+
+    for (i = key->sorted_values; i <= key->last_value; i++)
+    {
+        if (compare_names( get_value_name( key, i ), name )) continue;
+        *index = i;
+        return &key->values[i];
+    }
+    if (key->sorted_values <= key->last_value) *index = key->last_value + 1;
     return NULL;
 }
 
+static int compare_values( const void *ptr1, const void *ptr2 )
+{
+    const struct key_value *value1 = ptr1;
+    const struct key_value *value2 = ptr2;
+    int res = memicmp_strW( value1->name, value2->name, min( value1->namelen, value2->namelen ));
+
+    if (!res) res = value1->namelen - value2->namelen;
+    return res;
+}
+
+/* sort the values that were appended at the end of the array */
+static void sort_values( struct key *key )
+{
+    int i, j, k, count = key->last_value + 1, sorted = key->sorted_values;
+    struct key_value *tail;
+
+    if (sorted == count) return;
+
+    qsort( key->values + sorted, count - sorted, sizeof(*key->values), compare_values );
+    if (sorted && (tail = malloc( (count - sorted) * sizeof(*tail) )))
+    {
+        /* merge them with the sorted ones, starting from the end */
+        memcpy( tail, key->values + sorted, (count - sorted) * sizeof(*tail) );
+        for (i = sorted - 1, j = count - sorted - 1, k = count - 1; j >= 0; k--)
+        {
+            if (i >= 0 && compare_values( &key->values[i], &tail[j] ) > 0)
+                key->values[k] = key->values[i--];
+            else
+                key->values[k] = tail[j--];
+        }
+        free( tail );
+    }
+    else if (sorted) qsort( key->values, count, sizeof(*key->values), compare_values );
+
+    key->sorted_values = count;
+    if (key->value_index) rebuild_key_index( key, &key->value_index, get_value_name, count );
+}
+
 /* insert a new value; the index must have been returned by find_value */
 static struct key_value *insert_value( struct key *key, struct unicode_str name, int index )
 {
@@ -1156,6 +1419,8 @@ static struct key_value *insert_value( struct key *key, struct unicode_str name,
     value->namelen = name.len;
     value->len     = 0;
     value->data    = NULL;
+    entry_inserted( key, &key->sorted_values, &key->value_index, get_value_name,
+                    index, key->last_value + 1 );
     return value;
 }
 
@@ -1256,6 +1521,7 @@ static void enum_value( struct key *key, int i, int info_class, struct enum_key_
         void *data;
         data_size_t namelen, maxlen;
 
+        sort_values( key );
         value = &key->values[i];
         reply->type = value->type;
         namelen = value->namelen;
@@ -1314,10 +1580,13 @@ static void delete_value( struct key *key, struct unicode_str name )
         return;
     }
     if (debug_level > 1) dump_operation( key, value, "Delete" );
+    entry_removing( key, &key->sorted_values, &key->value_index, get_value_name,
+                    index, key->last_value + 1 );
     free( value->name );
     free( value->data );
     for (i = index; i < key->last_value; i++) key->values[i] = key->values[i + 1];
     key->last_value--;
+    if (!key->value_index) rebuild_key_index( key, &key->value_index, get_value_name, key->last_value + 1 );
     touch_key( key, REG_NOTIFY_CHANGE_LAST_SET );
 
     /* try to shrink the array */
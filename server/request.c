@@ -66,6 +66,9 @@
 #define SCM_RIGHTS 1
 #endif
 
+/* largest request data buffer that is kept for reuse by the next request */
+#define MAX_CACHED_REQUEST_DATA 65536
+
 /* path names for server master Unix socket */
 static const char * const server_socket_name = "socket";   /* name of the socket file */
 static const char * const server_lock_name = "lock";       /* name of the server lock file */
@@ -300,27 +303,58 @@ static void call_req_handler( struct thread *thread )
     current = NULL;
 }
 
+/* release the request data buffer if it grew too large to be worth keeping around */
+static void trim_request_data( struct thread *thread )
+{
+    if (thread->req_data_size <= MAX_CACHED_REQUEST_DATA) return;
+    free( thread->req_data );
+    thread->req_data = NULL;
+    thread->req_data_size = 0;
+}
+
 /* read a request from a thread */
 void read_request( struct thread *thread )
 {
+    struct iovec vec[2];
     int ret;
 
     if (!thread->req_toread)  /* no pending request */
     {
-        if ((ret = read( get_unix_fd( thread->request_fd ), &thread->req,
-                         sizeof(thread->req) )) != sizeof(thread->req)) goto error;
-        if (!(thread->req_toread = thread->req.request_header.request_size))
+        /* read the fixed part along with as much of the variable data as fits in the
+         * buffer kept from the previous request, to save a read() in the common case */
+        vec[0].iov_base = &thread->req;
+        vec[0].iov_len  = sizeof(thread->req);
+        vec[1].iov_base = thread->req_data;
+        vec[1].iov_len  = thread->req_data_size;
+        if ((ret = readv( get_unix_fd( thread->request_fd ), vec, 2 )) < (int)sizeof(thread->req))
+            goto error;
+        ret -= sizeof(thread->req);
+        if (ret > thread->req.request_header.request_size)
         {
-            /* no data, handle request at once */
-            call_req_handler( thread );
+            fatal_protocol_error( thread, "request data overflow %d\n", ret );
             return;
         }
-        if (!(thread->req_data = malloc( thread->req_toread )))
+        if (!(thread->req_toread = thread->req.request_header.request_size - ret))
         {
-            fatal_protocol_error( thread, "no memory for %u bytes request %d\n",
-                                  thread->req_toread, thread->req.request_header.req );
+            /* all the data is here, handle request at once */
+            call_req_handler( thread );
+            trim_request_data( thread );
             return;
         }
+        if (thread->req.request_header.request_size > thread->req_data_size)
+        {
+            void *data = realloc( thread->req_data, thread->req.request_header.request_size );
+
+            if (!data)
+            {
+                fatal_protocol_error( thread, "no memory for %u bytes request %d\n",
+                                      thread->req.request_header.request_size,
+                                      thread->req.request_header.req );
+                return;
+            }
+            thread->req_data = data;
+            thread->req_data_size = thread->req.request_header.request_size;
+        }
     }
 
     /* read the variable sized data */
@@ -334,8 +368,7 @@ void read_request( struct thread *thread )
         if (!(thread->req_toread -= ret))
         {
             call_req_handler( thread );
-            free( thread->req_data );
-            thread->req_data = NULL;
+            trim_request_data( thread );
             return;
         }
     }
@@ -23,6 +23,7 @@ static void dump_varargs_apc_call( const char *prefix, data_size_t size );
 static void dump_varargs_apc_result( const char *prefix, data_size_t size );
 static void dump_varargs_bytes( const char *prefix, data_size_t size );
 static void dump_varargs_class_info( const char *prefix, data_size_t size );
+static void dump_varargs_completion_msgs( const char *prefix, data_size_t size );
 static void dump_varargs_contexts( const char *prefix, data_size_t size );
 static void dump_varargs_cursor_positions( const char *prefix, data_size_t size );
 static void dump_varargs_debug_event( const char *prefix, data_size_t size );
@@ -3131,6 +3132,7 @@ static void dump_remove_completion_reply( const struct remove_completion_reply *
     dump_uint64( ", information=", &req->information );
     fprintf( stderr, ", status=%08x", req->status );
     fprintf( stderr, ", wait_handle=%04x", req->wait_handle );
+    dump_varargs_completion_msgs( ", msgs=", cur_size );
 }
 
 static void dump_get_thread_completion_request( const struct get_thread_completion_request *req )
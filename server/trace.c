@@ -1058,6 +1058,25 @@ static void dump_varargs_cursor_positions( const char *prefix, data_size_t size
     remove_data( size );
 }
 
+static void dump_varargs_completion_msgs( const char *prefix, data_size_t size )
+{
+    const struct completion_msg *msg = cur_data;
+    data_size_t len = size / sizeof(*msg);
+
+    fprintf( stderr, "%s{", prefix );
+    while (len > 0)
+    {
+        dump_uint64( "{ckey=", &msg->ckey );
+        dump_uint64( ",cvalue=", &msg->cvalue );
+        dump_uint64( ",information=", &msg->information );
+        fprintf( stderr, ",status=%08x}", msg->status );
+        msg++;
+        if (--len) fputc( ',', stderr );
+    }
+    fputc( '}', stderr );
+    remove_data( size );
+}
+
 static void dump_varargs_message_data( const char *prefix, data_size_t size )
 {
     /* FIXME: dump the structured data */